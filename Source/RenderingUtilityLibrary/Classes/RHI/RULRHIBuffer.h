@@ -259,6 +259,15 @@ struct FRULRWBufferStructured
         return IsValid() ? Buffer->GetSize() / Buffer->GetStride() : 0;
     }
 
+    // Returns true if the buffer is valid and already matches the specified layout
+    FORCEINLINE bool HasLayout(uint32 BytesPerElement, uint32 NumElements, uint32 AdditionalUsage = 0) const
+    {
+        return IsValid()
+            && Buffer->GetStride() == BytesPerElement
+            && NumBytes == (BytesPerElement * NumElements)
+            && (Buffer->GetUsage() & AdditionalUsage) == AdditionalUsage;
+    }
+
     void Initialize(
         uint32 BytesPerElement,
         uint32 NumElements,
@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderResource.h"
+#include "RHI/RULRHIBuffer.h"
+
+// Render thread pool of scratch structured buffers.
+//
+// Buffers are keyed by stride, usage and size class (element count rounded up
+// to the next power of two) so repeated requests of similar sizes reuse the
+// same RHI resources. Free buffers that stay unused for more than
+// MaxUnusedFrames frames are released, and the total bytes kept by the pool
+// never exceed MaxPooledBytes.
+class RENDERINGUTILITYLIBRARY_API FRULRHIBufferPool : public FRenderResource
+{
+public:
+
+    FRULRHIBufferPool();
+
+    static FRULRHIBufferPool& Get();
+
+    // Acquires a structured buffer with at least NumElements elements.
+    // The returned buffer is not cleared and may hold data from a previous user.
+    void AcquireStructured(
+        FRULRWBufferStructured& OutBuffer,
+        uint32 BytesPerElement,
+        uint32 NumElements,
+        uint32 AdditionalUsage = 0,
+        const TCHAR* InDebugName = NULL
+        );
+
+    // Returns the buffer resources to the pool and resets the buffer wrapper
+    void ReleaseStructured(FRULRWBufferStructured& Buffer);
+
+    // Releases free buffers that exceed unused frame count or pool budget
+    void Trim();
+
+    // Releases all free buffers
+    void Empty();
+
+    FORCEINLINE uint64 GetPooledBytes() const
+    {
+        return PooledBytes;
+    }
+
+    FORCEINLINE void SetMaxPooledBytes(uint64 InMaxPooledBytes)
+    {
+        MaxPooledBytes = InMaxPooledBytes;
+    }
+
+    FORCEINLINE void SetMaxUnusedFrames(uint32 InMaxUnusedFrames)
+    {
+        MaxUnusedFrames = InMaxUnusedFrames;
+    }
+
+    virtual void ReleaseDynamicRHI() override
+    {
+        Empty();
+    }
+
+private:
+
+    struct FPooledStructuredBuffer
+    {
+        FStructuredBufferRHIRef Buffer;
+        FUnorderedAccessViewRHIRef UAV;
+        FShaderResourceViewRHIRef SRV;
+        uint32 Stride;
+        uint32 NumBytes;
+        uint32 Usage;
+        uint32 LastUsedFrame;
+    };
+
+    TArray<FPooledStructuredBuffer> FreeStructuredBuffers;
+
+    uint64 PooledBytes;
+    uint64 MaxPooledBytes;
+    uint32 MaxUnusedFrames;
+    uint32 LastTrimFrame;
+
+    void RemoveFreeStructuredBuffer(int32 Index);
+};
+
+// Structured buffer acquired from FRULRHIBufferPool, returned to the pool on destruction.
+// The element count of a pooled buffer is its size class and may exceed the requested count.
+struct FRULPooledRWBufferStructured : public FRULRWBufferStructured
+{
+    ~FRULPooledRWBufferStructured()
+    {
+        ReleaseToPool();
+    }
+
+    void Acquire(
+        uint32 BytesPerElement,
+        uint32 NumElements,
+        uint32 AdditionalUsage = 0,
+        const TCHAR* InDebugName = NULL
+        )
+    {
+        ReleaseToPool();
+        FRULRHIBufferPool::Get().AcquireStructured(*this, BytesPerElement, NumElements, AdditionalUsage, InDebugName);
+    }
+
+    void ReleaseToPool()
+    {
+        if (IsValid())
+        {
+            FRULRHIBufferPool::Get().ReleaseStructured(*this);
+        }
+    }
+};
@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderResource.h"
+#include "RHIResources.h"
+
+// Render thread pool of transient render target textures.
+//
+// Textures are keyed by size, format, flags, sample count and clear value so
+// intermediate targets (e.g. multi-pass filter swap textures) reuse the same
+// RHI resources across draws. Free textures are kept in least recently used
+// order. Textures that stay unused for more than MaxUnusedFrames frames are
+// released, and the total bytes of free textures never exceed MaxPooledBytes.
+class RENDERINGUTILITYLIBRARY_API FRULRHIRenderTargetPool : public FRenderResource
+{
+public:
+
+    FRULRHIRenderTargetPool();
+
+    static FRULRHIRenderTargetPool& Get();
+
+    // Acquires a render targetable texture matching the specified description.
+    // The returned texture is not cleared and may hold data from a previous user.
+    FTexture2DRHIRef Acquire(
+        uint32 SizeX,
+        uint32 SizeY,
+        EPixelFormat Format,
+        uint32 Flags,
+        uint32 TargetableFlags,
+        uint32 NumSamples,
+        const FClearValueBinding& ClearBinding,
+        const TCHAR* InDebugName = NULL
+        );
+
+    // Acquires a texture that may be used as swap target of the specified texture
+    FTexture2DRHIRef AcquireSwapTexture(FTexture2DRHIParamRef TargetTexture);
+
+    // Returns the texture to the pool and resets the texture reference
+    void Release(FTexture2DRHIRef& Texture);
+
+    // Releases free textures that exceed unused frame count or pool budget
+    void Trim();
+
+    // Releases all free textures
+    void Empty();
+
+    FORCEINLINE uint64 GetPooledBytes() const
+    {
+        return PooledBytes;
+    }
+
+    FORCEINLINE void SetMaxPooledBytes(uint64 InMaxPooledBytes)
+    {
+        MaxPooledBytes = InMaxPooledBytes;
+    }
+
+    FORCEINLINE void SetMaxUnusedFrames(uint32 InMaxUnusedFrames)
+    {
+        MaxUnusedFrames = InMaxUnusedFrames;
+    }
+
+    virtual void ReleaseDynamicRHI() override
+    {
+        Empty();
+    }
+
+private:
+
+    struct FPooledRenderTarget
+    {
+        FTexture2DRHIRef Texture;
+        uint32 SizeX;
+        uint32 SizeY;
+        EPixelFormat Format;
+        uint32 Flags;
+        uint32 NumSamples;
+        FClearValueBinding ClearBinding;
+        uint64 NumBytes;
+        uint32 LastUsedFrame;
+    };
+
+    TArray<FPooledRenderTarget> FreeRenderTargets;
+
+    uint64 PooledBytes;
+    uint64 MaxPooledBytes;
+    uint32 MaxUnusedFrames;
+    uint32 LastTrimFrame;
+
+    static uint64 CalcTextureBytes(FTexture2DRHIParamRef Texture);
+
+    void RemoveFreeRenderTarget(int32 Index);
+};
+
+// Render target texture acquired from FRULRHIRenderTargetPool, returned to the pool on destruction
+struct FRULPooledRenderTarget
+{
+    FTexture2DRHIRef Texture;
+
+    ~FRULPooledRenderTarget()
+    {
+        ReleaseToPool();
+    }
+
+    void AcquireSwapTexture(FTexture2DRHIParamRef TargetTexture)
+    {
+        ReleaseToPool();
+        Texture = FRULRHIRenderTargetPool::Get().AcquireSwapTexture(TargetTexture);
+    }
+
+    void ReleaseToPool()
+    {
+        if (Texture.IsValid())
+        {
+            FRULRHIRenderTargetPool::Get().Release(Texture);
+        }
+    }
+};
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHIResources.h"
+
+class FRHICommandList;
+
+// Render thread upload point for transient draw data.
+//
+// Vertex, index and typed float4 SRV data are written to write-once volatile
+// buffers. The engine RHI has no no-overwrite lock mode, so sub-allocating
+// persistent buffers would either discard the whole buffer on every lock
+// (dynamic usage) or re-upload the whole buffer on every lock (static usage).
+// Uploads are routed through a single place so draw code stays independent of
+// the backing allocation and upload traffic is reported in the stat group.
+class RENDERINGUTILITYLIBRARY_API FRULRHIUploadHeap
+{
+public:
+
+    static FRULRHIUploadHeap& Get();
+
+    // Uploads vertex stream data, returns the buffer and byte offset to bind as stream source
+    void UploadVertexData(
+        FRHICommandList& RHICmdList,
+        const void* Data,
+        uint32 NumBytes,
+        FVertexBufferRHIRef& OutBuffer,
+        uint32& OutOffset
+        );
+
+    // Uploads index data, returns the buffer and the first index to draw from
+    void UploadIndexData(
+        FRHICommandList& RHICmdList,
+        const void* Data,
+        uint32 NumBytes,
+        uint32 Stride,
+        FIndexBufferRHIRef& OutBuffer,
+        uint32& OutStartIndex
+        );
+
+    // Uploads float4 elements, returns a Buffer<float4> SRV and the first element index
+    void UploadTypedData(
+        FRHICommandList& RHICmdList,
+        const FVector4* Data,
+        uint32 NumElements,
+        FShaderResourceViewRHIRef& OutSRV,
+        uint32& OutElementOffset
+        );
+};
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHIResources.h"
+
+class FRHICommandList;
+
+// Indexed triangle list geometry uploaded once into static GPU buffers.
+//
+// Buffers are created and drawn on the render thread. Geometry is shared
+// between the game thread handle and pending render commands, RHI resources
+// are released once the last reference goes away.
+class RENDERINGUTILITYLIBRARY_API FRULRetainedGeometry
+{
+public:
+
+    FVertexBufferRHIRef VertexBufferRHI;
+    FVertexBufferRHIRef ColorBufferRHI;
+    FIndexBufferRHIRef IndexBufferRHI;
+
+    int32 NumVertices;
+    int32 NumIndices;
+
+    FRULRetainedGeometry()
+        : NumVertices(0)
+        , NumIndices(0)
+    {
+    }
+
+    FORCEINLINE bool IsValid() const
+    {
+        return VertexBufferRHI.IsValid() && IndexBufferRHI.IsValid() && NumIndices >= 3;
+    }
+
+    FORCEINLINE bool HasColors() const
+    {
+        return ColorBufferRHI.IsValid();
+    }
+
+    // Uploads geometry into static buffers, colors are only used
+    // if the color count matches the vertex count
+    void Initialize_RT(
+        const TArray<FVector>& Vertices,
+        const TArray<int32>& Indices,
+        const TArray<FColor>* Colors = nullptr
+        );
+
+    void Release_RT();
+
+    // Binds vertex streams and draws the triangle list
+    void Draw_RT(FRHICommandList& RHICmdList) const;
+};
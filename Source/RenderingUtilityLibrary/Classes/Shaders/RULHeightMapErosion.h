@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderResource.h"
+#include "RHIResources.h"
+#include "RHI/RULRHIBuffer.h"
+#include "Shaders/RULShaderParameters.h"
+
+class FRHICommandListImmediate;
+
+// Pipe model hydraulic and thermal erosion simulation.
+//
+// Simulation buffers (water, sediment, flux, flow, thermal transfer and time
+// step data) persist between Simulate() calls and are only reallocated when
+// the simulation dimension changes, so consecutive calls continue the same
+// water and sediment state until ResetState() is called.
+//
+// Time step is adaptive. Every iteration reduces the maximum flow velocity
+// on the GPU and derives the next iteration time step from it, the time step
+// never leaves the GPU.
+//
+// Height maps must be single channel float textures (PF_R32_FLOAT) with
+// dimension of multiple of the kernel thread group size.
+class RENDERINGUTILITYLIBRARY_API FRULHeightMapErosion : public FRenderResource
+{
+public:
+
+    const static int32 THREAD_SIZE_X = 16;
+    const static int32 THREAD_SIZE_Y = 16;
+
+    // Number of elements reduced per delta time scan group
+    const static int32 SCAN_BLOCK_SIZE = 256;
+
+    // Maximum number of texels, delta time top level scan is a single group
+    const static int32 MAX_TEXEL_COUNT = THREAD_SIZE_X * THREAD_SIZE_Y * SCAN_BLOCK_SIZE * SCAN_BLOCK_SIZE;
+
+    // Time step of the first iteration after a state reset,
+    // also the upper bound of the adaptive time step
+    static constexpr float MAX_DELTA_T = .05f;
+
+    FRULHeightMapErosion();
+
+    // Shared simulation instance
+    static FRULHeightMapErosion& Get();
+
+    static bool IsValidDimension(const FIntPoint& InDimension)
+    {
+        return InDimension.X > 0
+            && InDimension.Y > 0
+            && (InDimension.X % THREAD_SIZE_X) == 0
+            && (InDimension.Y % THREAD_SIZE_Y) == 0
+            && (static_cast<int64>(InDimension.X) * InDimension.Y) <= MAX_TEXEL_COUNT;
+    }
+
+    FORCEINLINE bool IsInitialized() const
+    {
+        return Dimension.X > 0 && Dimension.Y > 0;
+    }
+
+    FORCEINLINE FIntPoint GetDimension() const
+    {
+        return Dimension;
+    }
+
+    // Allocates simulation buffers of the specified dimension.
+    // Existing buffers are kept if the dimension matches.
+    // Returns false if the dimension is invalid.
+    bool Initialize(FRHICommandListImmediate& RHICmdList, FIntPoint InDimension);
+
+    // Clears water, sediment and flow and resets the time step
+    void ResetState(FRHICommandListImmediate& RHICmdList);
+
+    void Release();
+
+    // Runs IterationCount simulation iterations on the height texture.
+    // Simulation buffers are initialized to the height texture dimension
+    // (state is reset if the dimension changes).
+    // Returns the number of iterations or -1 if the inputs are invalid.
+    int32 Simulate(
+        FRHICommandListImmediate& RHICmdList,
+        FTexture2DRHIParamRef HeightTexture,
+        int32 IterationCount,
+        const FRULShaderErosionConfig& Config
+        );
+
+    // Writes current flow velocity magnitude to the output texture.
+    // Output texture must match the simulation dimension and be PF_R32_FLOAT.
+    bool WriteFlowMagnitude(FRHICommandListImmediate& RHICmdList, FTexture2DRHIParamRef OutputTexture);
+
+    virtual void ReleaseDynamicRHI() override
+    {
+        Release();
+    }
+
+private:
+
+    struct FKernelParameters;
+
+    FIntPoint Dimension;
+
+    FRULRWBuffer WaterData;
+    FRULRWBuffer SedimentData;
+    FRULRWBuffer SedimentTransferData;
+    FRULRWBuffer ThermalTransferDataAA;
+    FRULRWBuffer ThermalTransferDataAX;
+    FRULRWBuffer DeltaTData;
+    FRULRWBuffer DeltaTScanData;
+    FRULRWBufferStructured FluxData;
+    FRULRWBufferStructured FlowData;
+
+    FIntPoint GetDispatchCount() const
+    {
+        return { Dimension.X / THREAD_SIZE_X, Dimension.Y / THREAD_SIZE_Y };
+    }
+
+    template<typename FShaderType>
+    void DispatchKernel(
+        FRHICommandListImmediate& RHICmdList,
+        const FKernelParameters& Parameters,
+        FTextureRHIParamRef HeightTexture,
+        FUnorderedAccessViewRHIParamRef HeightUAV,
+        FIntPoint GroupCount,
+        uint32 ScanElementCount = 0
+        );
+};
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Shaders/RULShaderParameters.h"
+#include "RULOpBatch.generated.h"
+
+class UMaterialInterface;
+class UTexture;
+class UTextureRenderTarget2D;
+class UGWTTickEvent;
+
+UENUM(BlueprintType)
+enum class ERULOpBatchType : uint8
+{
+    RUL_OBT_ApplyMaterial,
+    RUL_OBT_ApplyMaterialFilter,
+    RUL_OBT_DrawTexture,
+    RUL_OBT_ApplyAutoLevels
+};
+
+USTRUCT(BlueprintType)
+struct RENDERINGUTILITYLIBRARY_API FRULOpBatchEntry
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadWrite)
+    ERULOpBatchType Type = ERULOpBatchType::RUL_OBT_ApplyMaterial;
+
+    UPROPERTY(BlueprintReadWrite)
+    UMaterialInterface* Material = nullptr;
+
+    UPROPERTY(BlueprintReadWrite)
+    FRULShaderTextureParameterInput SourceTexture;
+
+    UPROPERTY(BlueprintReadWrite)
+    UTexture* Texture = nullptr;
+
+    UPROPERTY(BlueprintReadWrite)
+    UTextureRenderTarget2D* RenderTarget = nullptr;
+
+    UPROPERTY(BlueprintReadWrite)
+    UTextureRenderTarget2D* SwapTarget = nullptr;
+
+    UPROPERTY(BlueprintReadWrite)
+    FRULShaderDrawConfig DrawConfig;
+
+    UPROPERTY(BlueprintReadWrite)
+    int32 RepeatCount = 0;
+
+    UPROPERTY(BlueprintReadWrite)
+    bool bApplyLevelMin = true;
+
+    UPROPERTY(BlueprintReadWrite)
+    bool bApplyLevelMax = true;
+};
+
+// Records a sequence of shader library operations and executes them
+// within a single render command. Operations share scene views, swap
+// textures and material uniform expression updates, and signal a single
+// callback event once all operations are submitted.
+//
+// Texture reductions are batched through ApplyAutoLevels, which reduces the
+// source min / max on the render thread and applies them without a readback.
+// Reductions returning values to the game thread are not batched since they
+// would stall the batch on a readback.
+UCLASS(BlueprintType)
+class RENDERINGUTILITYLIBRARY_API URULOpBatch : public UObject
+{
+	GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FRULOpBatchEntry> Ops;
+
+public:
+
+    UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+    static URULOpBatch* CreateOpBatch(UObject* WorldContextObject);
+
+    UFUNCTION(BlueprintCallable)
+    void AddApplyMaterial(
+        UMaterialInterface* Material,
+        UTextureRenderTarget2D* RenderTarget,
+        FRULShaderDrawConfig DrawConfig
+        );
+
+    UFUNCTION(BlueprintCallable)
+    void AddApplyMaterialFilter(
+        UMaterialInterface* Material,
+        int32 RepeatCount,
+        FRULShaderDrawConfig DrawConfig,
+        FRULShaderTextureParameterInput SourceTexture,
+        UTextureRenderTarget2D* RenderTarget,
+        UTextureRenderTarget2D* SwapTarget = nullptr
+        );
+
+    UFUNCTION(BlueprintCallable)
+    void AddDrawTexture(
+        UTexture* SourceTexture,
+        UTextureRenderTarget2D* RenderTarget,
+        FRULShaderDrawConfig DrawConfig
+        );
+
+    UFUNCTION(BlueprintCallable)
+    void AddApplyAutoLevels(
+        UTexture* SourceTexture,
+        UTextureRenderTarget2D* RenderTarget,
+        FRULShaderDrawConfig DrawConfig,
+        bool bApplyLevelMin = true,
+        bool bApplyLevelMax = true
+        );
+
+    // Submits all recorded operations in order and clears the batch
+    UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject", AdvancedDisplay="CallbackEvent"))
+    void Execute(UObject* WorldContextObject, UGWTTickEvent* CallbackEvent = nullptr);
+
+    UFUNCTION(BlueprintCallable)
+    void Reset();
+
+    UFUNCTION(BlueprintCallable)
+    int32 GetOpCount() const;
+};
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHIResources.h"
+#include "RHI/RULRHIBuffer.h"
+#include "Shaders/RULShaderParameters.h"
+
+class FRHICommandListImmediate;
+class FRHIGPUBufferReadback;
+
+// Compute splatting of radial falloff points into a float texture.
+//
+// Points are binned into screen tiles of TILE_SIZE x TILE_SIZE pixels: a count
+// kernel counts the points overlapping each tile, FRULPrefixSumScan exclusive
+// scans the counts into bin offsets and a write kernel stores point indices
+// into per tile bins. A tile kernel then runs one thread group per tile that
+// only visits the points binned to it and accumulates the falloff of each
+// point in registers, so output pixels are written once without atomics.
+// Scratch buffers are kept by the splat instance and reused across calls.
+//
+// The bin capacity is grow-only and never read back within a call. The write
+// kernel records the required entry count whenever bins overflow, the count
+// is read back asynchronously and grows the capacity of subsequent calls.
+class RENDERINGUTILITYLIBRARY_API FRULPointSplat
+{
+public:
+
+    const static int32 BLOCK_SIZE = 256;
+    const static int32 TILE_SIZE  = 16;
+
+    FRULPointSplat();
+    ~FRULPointSplat();
+
+    // Accumulates the first PointCount points of PointBuffer into OutputTextureUAV.
+    //
+    // Point buffer elements are float4 of (position x, position y, radius, value)
+    // in pixels. Each point contributes (1 - distance/radius) * value to pixels
+    // within its radius. Output UAV must be a single channel 32-bit float texture
+    // of the specified dimension, supported blend types are max, min and add.
+    //
+    // MaxBinEntries sets an explicit total number of point to tile bin entries,
+    // entries exceeding the limit are dropped. If MaxBinEntries is not
+    // specified the instance bin capacity is used. Entries dropped by an
+    // overflowing call grow the capacity of following calls once the overflow
+    // count has been read back, the call itself never waits for the GPU.
+    // Returns the bin entry capacity used or -1 if the inputs are invalid.
+    int32 Splat(
+        FRHICommandListImmediate& RHICmdList,
+        FRULRWBufferStructured& PointBuffer,
+        int32 PointCount,
+        FUnorderedAccessViewRHIParamRef OutputTextureUAV,
+        FIntPoint Dimension,
+        ERULShaderDrawBlendType BlendType,
+        int32 MaxBinEntries = 0
+        );
+
+    // Releases scratch buffers
+    void Release();
+
+private:
+
+    FRULRWBufferStructured TileCountData;
+    FRULRWBufferStructured TileOffsetData;
+    FRULRWBufferStructured SumData;
+    FRULRWBufferStructured BinData;
+
+    // Required bin entry count of the last overflowing call
+    FRULRWBuffer OverflowData;
+    TUniquePtr<FRHIGPUBufferReadback> OverflowReadback;
+    bool bOverflowReadbackPending;
+    int32 BinCapacity;
+
+    void UpdateBinCapacity(int32 PointCount, int32 TileCount);
+
+    template<uint32 BlendMode>
+    void SplatTiles(
+        FRHICommandListImmediate& RHICmdList,
+        FRULRWBufferStructured& PointBuffer,
+        FUnorderedAccessViewRHIParamRef OutputTextureUAV,
+        FIntPoint Dimension,
+        FIntPoint TileDimension,
+        int32 MaxBinEntries
+        );
+};
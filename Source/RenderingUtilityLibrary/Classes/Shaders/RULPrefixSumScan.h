@@ -36,43 +36,112 @@ class RENDERINGUTILITYLIBRARY_API FRULPrefixSumScan
 {
 public:
 
+    // Scan data types, uint types match the scan dimension values
+    // used by earlier ExclusiveScan<1/2/4> call sites
+    enum FScanDataType
+    {
+        SDT_UINT1 = 0x01,
+        SDT_UINT2 = 0x02,
+        SDT_UINT4 = 0x04,
+        SDT_FLOAT1 = 0x11,
+        SDT_FLOAT2 = 0x12,
+        SDT_FLOAT4 = 0x14,
+        SDT_INT1 = 0x21,
+        SDT_INT2 = 0x22,
+        SDT_INT4 = 0x24
+    };
+
     const static int32 BLOCK_SIZE  = 128;
     const static int32 BLOCK_SIZE2 = 256;
 
+    // Maximum number of block sum levels of the scan hierarchy.
+    // Each level divides the element count by BLOCK_SIZE2.
+    const static int32 MAX_BLOCK_LEVELS = 4;
+
+    // Number of uint32 values of a level dispatch arguments buffer,
+    // scan and add offset dispatch arguments (X, Y, Z) of every block level
+    const static int32 LEVEL_ARGS_COUNT = MAX_BLOCK_LEVELS * 3 * 2;
+
+    FORCEINLINE static uint32 GetScanArgsOffset(int32 Level)
+    {
+        return Level * 3 * sizeof(uint32);
+    }
+
+    FORCEINLINE static uint32 GetAddOffsetArgsOffset(int32 Level)
+    {
+        return (MAX_BLOCK_LEVELS + Level) * 3 * sizeof(uint32);
+    }
+
     FORCEINLINE static int32 GetBlockOffsetForSize(int32 ElementCount)
     {
         return FPlatformMath::RoundUpToPowerOfTwo(FMath::DivideAndRoundUp(ElementCount, BLOCK_SIZE2));
     }
 
-    template<uint32 ScanDimension>
-    static const TCHAR* GetScanDimensionName()
+    // Number of block sum levels required until the block sums fit within
+    // a single top level scan group. Returns -1 if the element count
+    // exceeds MAX_BLOCK_LEVELS.
+    static int32 GetBlockLevelCount(int32 ElementCount)
     {
-        switch (ScanDimension)
+        int32 LevelCount = 0;
+        int64 LevelElementCount = ElementCount;
+        do
         {
-            case 1: return TEXT("uint");
-            case 2: return TEXT("uint2");
-            case 4: return TEXT("uint4");
-            default:
-                return TEXT("uint");
+            LevelElementCount = FMath::DivideAndRoundUp<int64>(LevelElementCount, BLOCK_SIZE2);
+            ++LevelCount;
         }
+        while (LevelElementCount > BLOCK_SIZE2);
+        return (LevelCount <= MAX_BLOCK_LEVELS) ? LevelCount : -1;
     }
 
-    template<uint32 ScanDimension>
-    static bool IsValidScanDimension()
+    template<uint32 ScanDataType>
+    static FString GetScanDataTypeName()
     {
-        switch (ScanDimension)
+        FString DataType(TEXT("uint"));
+        int32 Dimension = 1;
+        switch (ScanDataType & 0x0F)
         {
-            case 1:
-            case 2:
-            case 4:
-                return true;
+            case 1: Dimension = 1; break;
+            case 2: Dimension = 2; break;
+            case 4: Dimension = 4; break;
+        }
+        switch ((ScanDataType>>4) & 0x0F)
+        {
+            case 0: DataType = TEXT("uint"); break;
+            case 1: DataType = TEXT("float"); break;
+            case 2: DataType = TEXT("int"); break;
+        }
+        return DataType + FString::FromInt(Dimension);
+    }
+
+    template<uint32 ScanDataType>
+    static int32 GetScanDataTypeStride()
+    {
+        return (ScanDataType & 0x0F) * sizeof(uint32);
+    }
 
-            default:
-                return false;
+    template<uint32 ScanDataType>
+    static bool IsValidScanDataType()
+    {
+        switch (ScanDataType)
+        {
+            case SDT_UINT1:
+            case SDT_UINT2:
+            case SDT_UINT4:
+            case SDT_FLOAT1:
+            case SDT_FLOAT2:
+            case SDT_FLOAT4:
+            case SDT_INT1:
+            case SDT_INT2:
+            case SDT_INT4:
+                return true;
         }
+        return false;
     }
 
-    template<uint32 ScanDimension>
+    // ScanResult[i] = sum of SrcData[0..i-1].
+    // SumBuffer holds the scanned block sums, the total sum
+    // is written at the returned scan block count.
+    template<uint32 ScanDataType>
     static int32 ExclusiveScan(
         FRHICommandListImmediate& RHICmdList,
         FShaderResourceViewRHIParamRef SrcDataSRV,
@@ -81,6 +150,98 @@ public:
         FRULRWBufferStructured& ScanResult,
         FRULRWBufferStructured& SumBuffer,
         uint32 AdditionalOutputUsage = 0
+        )
+    {
+        return Scan<ScanDataType, 0, 0>(RHICmdList, SrcDataSRV, DataStride, ElementCount, ScanResult, SumBuffer, AdditionalOutputUsage);
+    }
+
+    // ExclusiveScan() of a GPU generated element count.
+    //
+    // The element count is read from ElementCountSRV[ElementCountIndex] (uint
+    // typed buffer, e.g. FRULStreamCompaction indirect arguments) and clamped
+    // to MaxElementCount. Output buffers are sized for MaxElementCount, only
+    // elements below the GPU element count are written. Dispatches are sized
+    // with indirect arguments written into DispatchArgsBuffer, a scratch buffer
+    // kept by the caller to be reused across calls.
+    // Returns the sum buffer index of the total sum.
+    template<uint32 ScanDataType>
+    static int32 ExclusiveScan(
+        FRHICommandListImmediate& RHICmdList,
+        FShaderResourceViewRHIParamRef SrcDataSRV,
+        int32 DataStride,
+        int32 MaxElementCount,
+        FShaderResourceViewRHIParamRef ElementCountSRV,
+        int32 ElementCountIndex,
+        FRULRWBufferStructured& ScanResult,
+        FRULRWBufferStructured& SumBuffer,
+        FRULRWBuffer& DispatchArgsBuffer,
+        uint32 AdditionalOutputUsage = 0
+        )
+    {
+        return Scan<ScanDataType, 0, 1>(RHICmdList, SrcDataSRV, DataStride, MaxElementCount, ScanResult, SumBuffer, AdditionalOutputUsage, ElementCountSRV, ElementCountIndex, &DispatchArgsBuffer);
+    }
+
+    // ScanResult[i] = sum of SrcData[0..i], SumBuffer layout matches ExclusiveScan()
+    template<uint32 ScanDataType>
+    static int32 InclusiveScan(
+        FRHICommandListImmediate& RHICmdList,
+        FShaderResourceViewRHIParamRef SrcDataSRV,
+        int32 DataStride,
+        int32 ElementCount,
+        FRULRWBufferStructured& ScanResult,
+        FRULRWBufferStructured& SumBuffer,
+        uint32 AdditionalOutputUsage = 0
+        )
+    {
+        return Scan<ScanDataType, 1, 0>(RHICmdList, SrcDataSRV, DataStride, ElementCount, ScanResult, SumBuffer, AdditionalOutputUsage);
+    }
+
+    // InclusiveScan() of a GPU generated element count, see ExclusiveScan()
+    template<uint32 ScanDataType>
+    static int32 InclusiveScan(
+        FRHICommandListImmediate& RHICmdList,
+        FShaderResourceViewRHIParamRef SrcDataSRV,
+        int32 DataStride,
+        int32 MaxElementCount,
+        FShaderResourceViewRHIParamRef ElementCountSRV,
+        int32 ElementCountIndex,
+        FRULRWBufferStructured& ScanResult,
+        FRULRWBufferStructured& SumBuffer,
+        FRULRWBuffer& DispatchArgsBuffer,
+        uint32 AdditionalOutputUsage = 0
+        )
+    {
+        return Scan<ScanDataType, 1, 1>(RHICmdList, SrcDataSRV, DataStride, MaxElementCount, ScanResult, SumBuffer, AdditionalOutputUsage, ElementCountSRV, ElementCountIndex, &DispatchArgsBuffer);
+    }
+
+    // Reads the element count ElementCountSRV[ElementCountIndex] on the GPU,
+    // clamped to MaxElementCount, and writes the element count of every block
+    // level (MAX_BLOCK_LEVELS+1 uint values) into LevelCountBuffer and the level
+    // dispatch arguments into DispatchArgsBuffer. Dispatch arguments wrap group
+    // counts by the dispatch widths of the MaxElementCount levels.
+    static void WriteLevelDispatchArgs(
+        FRHICommandListImmediate& RHICmdList,
+        FShaderResourceViewRHIParamRef ElementCountSRV,
+        int32 ElementCountIndex,
+        int32 MaxElementCount,
+        FRULRWBufferStructured& LevelCountBuffer,
+        FRULRWBuffer& DispatchArgsBuffer
+        );
+
+private:
+
+    template<uint32 ScanDataType, uint32 bInclusive, uint32 bIndirectCount>
+    static int32 Scan(
+        FRHICommandListImmediate& RHICmdList,
+        FShaderResourceViewRHIParamRef SrcDataSRV,
+        int32 DataStride,
+        int32 ElementCount,
+        FRULRWBufferStructured& ScanResult,
+        FRULRWBufferStructured& SumBuffer,
+        uint32 AdditionalOutputUsage,
+        FShaderResourceViewRHIParamRef ElementCountSRV = nullptr,
+        int32 ElementCountIndex = 0,
+        FRULRWBuffer* DispatchArgsBuffer = nullptr
         );
 };
 
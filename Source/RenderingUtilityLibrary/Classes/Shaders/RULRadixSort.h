@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHIResources.h"
+#include "RHI/RULRHIBuffer.h"
+
+class FRHICommandListImmediate;
+
+// Stable GPU radix sort of uint32 keys with optional uint32 payload.
+//
+// Each pass sorts RADIX_BITS bits of the key: a count kernel builds per group
+// digit histograms, FRULPrefixSumScan exclusive scans them into global digit
+// offsets and a scatter kernel writes elements to their stable ranks.
+// Scratch buffers are kept by the sort instance and reused across calls.
+class RENDERINGUTILITYLIBRARY_API FRULRadixSort
+{
+public:
+
+    const static int32 BLOCK_SIZE  = 128;
+    const static int32 BLOCK_SIZE2 = 256;
+
+    const static int32 RADIX_BITS = 4;
+    const static int32 RADIX_SIZE = 1 << RADIX_BITS;
+
+    ~FRULRadixSort()
+    {
+        Release();
+    }
+
+    // Sorts the first ElementCount keys of KeyBuffer in place, ordered by
+    // key bits [StartBit, EndBit). If ValueBuffer is specified its values
+    // are reordered along with the keys.
+    // Returns the number of sort passes or -1 if the inputs are invalid.
+    int32 Sort(
+        FRHICommandListImmediate& RHICmdList,
+        FRULRWBufferStructured& KeyBuffer,
+        FRULRWBufferStructured* ValueBuffer,
+        int32 ElementCount,
+        int32 StartBit = 0,
+        int32 EndBit = 32
+        );
+
+    // Releases scratch buffers
+    void Release();
+
+private:
+
+    FRULRWBufferStructured ScratchKeys;
+    FRULRWBufferStructured ScratchValues;
+    FRULRWBufferStructured HistogramData;
+    FRULRWBufferStructured OffsetData;
+    FRULRWBufferStructured SumData;
+
+    template<uint32 bUseValues>
+    int32 SortPasses(
+        FRHICommandListImmediate& RHICmdList,
+        FRULRWBufferStructured& KeyBuffer,
+        FRULRWBufferStructured* ValueBuffer,
+        int32 ElementCount,
+        int32 StartBit,
+        int32 EndBit
+        );
+};
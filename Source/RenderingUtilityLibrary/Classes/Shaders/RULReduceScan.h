@@ -50,7 +50,31 @@ public:
     enum FScanOpType
     {
         SOT_Max = 0,
-        SOT_Min = 1
+        SOT_Min = 1,
+        // Fused min and max, writes min and max into two consecutive results
+        SOT_MinMax = 2,
+        SOT_Sum = 3,
+        // Sum accumulated as float with error-free two-sum compensation,
+        // use for large element counts
+        SOT_SumCompensated = 4,
+        // Mean and population variance accumulated as float (parallel Welford),
+        // writes mean and variance into two consecutive results
+        SOT_MeanVariance = 5,
+        // Arg reductions, write the reduced value followed by the X and Y
+        // location of the first matching element (texel coordinate for
+        // ReduceTexture, element index and zero for Reduce). All three
+        // results are written as raw bits, locations are read as uint.
+        SOT_ArgMin = 6,
+        SOT_ArgMax = 7
+    };
+
+    enum FReduceMethod
+    {
+        // Local scan, block scan, top level scan and write result dispatches
+        RM_MultiPass = 0,
+        // Single dispatch, partials combined by the last group to finish.
+        // Falls back to RM_MultiPass if the platform does not support it.
+        RM_SinglePass = 1
     };
 
     const static int32 BLOCK_SIZE  = 128;
@@ -59,11 +83,35 @@ public:
     const static int32 TEX_BLOCK  = 8;
     const static int32 TEX_BLOCK2 = 16;
 
+    // Maximum group count of single pass reduction, the last group
+    // reduces all group partials within a single block
+    const static int32 SINGLE_PASS_MAX_GROUPS = BLOCK_SIZE2;
+
+    // Maximum number of block sum levels of the multi-pass scan hierarchy.
+    // Each level divides the element count by BLOCK_SIZE2.
+    const static int32 MAX_BLOCK_LEVELS = 4;
+
     FORCEINLINE static int32 GetBlockOffsetForSize(int32 ElementCount)
     {
         return FPlatformMath::RoundUpToPowerOfTwo(FMath::DivideAndRoundUp(ElementCount, BLOCK_SIZE2));
     }
 
+    // Number of block sum levels required until the block sums fit within
+    // a single top level scan group. Returns -1 if the element count
+    // exceeds MAX_BLOCK_LEVELS.
+    static int32 GetBlockLevelCount(int32 ElementCount)
+    {
+        int32 LevelCount = 0;
+        int64 LevelElementCount = ElementCount;
+        do
+        {
+            LevelElementCount = FMath::DivideAndRoundUp<int64>(LevelElementCount, BLOCK_SIZE2);
+            ++LevelCount;
+        }
+        while (LevelElementCount > BLOCK_SIZE2);
+        return (LevelCount <= MAX_BLOCK_LEVELS) ? LevelCount : -1;
+    }
+
     template<uint32 ScanDataType>
     static FString GetScanDataTypeName()
     {
@@ -83,6 +131,28 @@ public:
         return DataType + FString::FromInt(Dimension);
     }
 
+    // Floating point type with the same dimension as the scan data type,
+    // used to accumulate statistic operations
+    template<uint32 ScanDataType>
+    static FString GetScanAccumTypeName()
+    {
+        return FString(TEXT("float")) + FString::FromInt(ScanDataType & 0x0F);
+    }
+
+    // Unsigned integer type with the same dimension as the scan data type,
+    // used to carry element indices of arg operations
+    template<uint32 ScanDataType>
+    static FString GetScanIndexTypeName()
+    {
+        return FString(TEXT("uint")) + FString::FromInt(ScanDataType & 0x0F);
+    }
+
+    template<uint32 ScanDataType>
+    static int32 GetScanDataTypeStride()
+    {
+        return (ScanDataType & 0x0F) * sizeof(uint32);
+    }
+
     template<uint32 ScanDataType>
     static bool IsValidScanDataType()
     {
@@ -106,12 +176,59 @@ public:
         {
             case SOT_Max:
             case SOT_Min:
+            case SOT_MinMax:
+            case SOT_Sum:
+            case SOT_SumCompensated:
+            case SOT_MeanVariance:
+            case SOT_ArgMin:
+            case SOT_ArgMax:
                 return true;
         }
         return false;
     }
 
-    template<uint32 ScanDataType, uint32 ScanOpType = SOT_Max>
+    // Number of consecutive results written by a scan operation
+    template<uint32 ScanOpType>
+    static int32 GetScanOpOutputCount()
+    {
+        switch (ScanOpType)
+        {
+            case SOT_MinMax:
+            case SOT_MeanVariance:
+                return 2;
+            case SOT_ArgMin:
+            case SOT_ArgMax:
+                return 3;
+        }
+        return 1;
+    }
+
+    // Number of data values carried per element by intermediate scan buffers
+    template<uint32 ScanOpType>
+    static int32 GetScanOpReducedValueCount()
+    {
+        switch (ScanOpType)
+        {
+            case SOT_MinMax:
+            case SOT_SumCompensated:
+            case SOT_ArgMin:
+            case SOT_ArgMax:
+                return 2;
+            case SOT_MeanVariance:
+                return 3;
+        }
+        return 1;
+    }
+
+    // Single pass reduction requires globally coherent buffers and device memory
+    // barriers, only enabled on D3D and Vulkan SM5 shader platforms
+    static bool IsSinglePassSupported(EShaderPlatform Platform)
+    {
+        return IsFeatureLevelSupported(Platform, ERHIFeatureLevel::SM5)
+            && (IsD3DPlatform(Platform, false) || IsVulkanSM5Platform(Platform));
+    }
+
+    template<uint32 ScanDataType, uint32 ScanOpType = SOT_Max, uint32 ReduceMethod = RM_MultiPass>
     static int32 Reduce(
         FRHICommandListImmediate& RHICmdList,
         FShaderResourceViewRHIParamRef SrcDataSRV,
@@ -121,7 +238,27 @@ public:
         uint32 AdditionalOutputUsage = 0
         );
 
-    template<uint32 ScanOpType>
+    // Multi-pass Reduce() of a GPU generated element count.
+    //
+    // The element count is read from ElementCountSRV[ElementCountIndex] (uint
+    // typed buffer, e.g. FRULStreamCompaction indirect arguments) and clamped
+    // to MaxElementCount. Dispatches are sized with indirect arguments written
+    // into DispatchArgsBuffer, a scratch buffer kept by the caller.
+    // A zero GPU element count writes the default value of the operation.
+    template<uint32 ScanDataType, uint32 ScanOpType = SOT_Max>
+    static int32 Reduce(
+        FRHICommandListImmediate& RHICmdList,
+        FShaderResourceViewRHIParamRef SrcDataSRV,
+        FRULRWBufferStructured& ResultBuffer,
+        int32 DataStride,
+        int32 MaxElementCount,
+        FShaderResourceViewRHIParamRef ElementCountSRV,
+        int32 ElementCountIndex,
+        FRULRWBuffer& DispatchArgsBuffer,
+        uint32 AdditionalOutputUsage = 0
+        );
+
+    template<uint32 ScanOpType, uint32 ReduceMethod = RM_MultiPass>
     static int32 ReduceTexture(
         FRHICommandListImmediate& RHICmdList,
         FTextureRHIParamRef SourceTexture,
@@ -131,4 +268,53 @@ public:
         bool bInitializeResultBuffer = true,
         uint32 AdditionalOutputUsage = 0
         );
+
+    // Reduce N independent ranges of SrcData in a single dispatch.
+    //
+    // SegmentOffsetsSRV holds SegmentCount+1 uint offsets, segment i covers
+    // elements [Offsets[i], Offsets[i+1]). Results of segment i are written
+    // into ResultBuffer starting at i * GetScanOpOutputCount<ScanOpType>().
+    // Arg operation locations are element indices into SrcData.
+    // Each segment is reduced by a single thread group, best suited
+    // for many small ranges.
+    template<uint32 ScanDataType, uint32 ScanOpType = SOT_Max>
+    static int32 ReduceSegmented(
+        FRHICommandListImmediate& RHICmdList,
+        FShaderResourceViewRHIParamRef SrcDataSRV,
+        FShaderResourceViewRHIParamRef SegmentOffsetsSRV,
+        FRULRWBufferStructured& ResultBuffer,
+        int32 DataStride,
+        int32 ElementCount,
+        int32 SegmentCount,
+        uint32 AdditionalOutputUsage = 0
+        );
+
+private:
+
+    // Scan block sums level by level and write the reduced result
+    template<uint32 ScanDataType, uint32 ScanOpType, uint32 bIndirectCount>
+    static void ReduceBlockLevels(
+        FRHICommandListImmediate& RHICmdList,
+        FRULRWBufferStructured& SumBuffer,
+        int32 BlockCount,
+        FRULRWBufferStructured& ResultBuffer,
+        const FIntVector4& DimensionData,
+        int32 ResultIndex,
+        int32 ReducedStride,
+        FShaderResourceViewRHIParamRef LevelCountSRV = nullptr,
+        FVertexBufferRHIParamRef ArgumentBuffer = nullptr
+        );
+
+    template<uint32 ScanDataType, uint32 ScanOpType, uint32 bUseTexture>
+    static int32 ReduceSinglePass(
+        FRHICommandListImmediate& RHICmdList,
+        FShaderResourceViewRHIParamRef SrcDataSRV,
+        FTextureRHIParamRef SourceTexture,
+        FRULRWBufferStructured& ResultBuffer,
+        FIntPoint Dimension,
+        int32 DataStride,
+        int32 ElementCount,
+        int32 ResultIndex,
+        uint32 AdditionalOutputUsage
+        );
 };
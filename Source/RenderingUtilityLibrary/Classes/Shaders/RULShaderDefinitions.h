@@ -137,12 +137,24 @@ protected:
     typedef TMap<FName, FResourceId>  FResourceMapType;
     typedef TMap<FName, FParameterId> FParameterMapType;
 
+    typedef TArray<FShaderResourceParameter*, TInlineAllocator<4>> FResourceSlotArrayType;
+    typedef TArray<FShaderParameter*, TInlineAllocator<4>>         FParameterSlotArrayType;
+
     FResourceMapType  TextureMap;
     FResourceMapType  SamplerMap;
     FResourceMapType  SRVMap;
     FResourceMapType  UAVMap;
     FParameterMapType ParameterMap;
 
+    // Parameters in declaration order, indexed by the Slot_ enums
+    // generated by RUL_DECLARE_SHADER_PARAMETERS_N
+
+    FResourceSlotArrayType  TextureSlots;
+    FResourceSlotArrayType  SamplerSlots;
+    FResourceSlotArrayType  SRVSlots;
+    FResourceSlotArrayType  UAVSlots;
+    FParameterSlotArrayType ParameterSlots;
+
 public:
 
     typedef ShaderMetaType FRULShaderMetaType;
@@ -217,6 +229,8 @@ public:
     {
         for (FResourceId& Parameter : Parameters)
         {
+            TextureSlots.Emplace(Parameter.Value);
+
             if (Parameter.Value)
             {
                 TextureMap.Emplace(FName(*Parameter.Key), Parameter);
@@ -228,6 +242,8 @@ public:
     {
         for (FResourceId& Parameter : Parameters)
         {
+            SamplerSlots.Emplace(Parameter.Value);
+
             if (Parameter.Value)
             {
                 SamplerMap.Emplace(FName(*Parameter.Key), Parameter);
@@ -239,6 +255,8 @@ public:
     {
         for (FResourceId& Parameter : Parameters)
         {
+            SRVSlots.Emplace(Parameter.Value);
+
             if (Parameter.Value)
             {
                 SRVMap.Emplace(FName(*Parameter.Key), Parameter);
@@ -250,6 +268,8 @@ public:
     {
         for (FResourceId& Parameter : Parameters)
         {
+            UAVSlots.Emplace(Parameter.Value);
+
             if (Parameter.Value)
             {
                 UAVMap.Emplace(FName(*Parameter.Key), Parameter);
@@ -261,6 +281,8 @@ public:
     {
         for (FParameterId& Parameter : Parameters)
         {
+            ParameterSlots.Emplace(Parameter.Value);
+
             if (Parameter.Value)
             {
                 ParameterMap.Emplace(FName(*Parameter.Key), Parameter);
@@ -371,32 +393,82 @@ public:
         }
     }
 
-    void UnbindBuffers(FRHICommandList& RHICmdList)
+    // Slot bindings. Slot indices are the Slot_ enums generated by
+    // RUL_DECLARE_SHADER_PARAMETERS_N, resolved at compile time so binds
+    // skip the name lookup of the FName based functions above.
+
+    void BindTexture(FRHICommandList& RHICmdList, int32 TextureSlot, FTextureRHIParamRef TextureParameter)
     {
-        for (auto& ResourcePair : TextureMap)
+        FShaderResourceParameter* Parameter(TextureSlots[TextureSlot]);
+
+        if (Parameter && Parameter->IsBound())
+        {
+            SetTextureTyped(RHICmdList, *Parameter, TextureParameter);
+        }
+    }
+
+    void BindTexture(FRHICommandList& RHICmdList, int32 TextureSlot, int32 SamplerSlot, FTextureRHIParamRef TextureParameter, FSamplerStateRHIParamRef SamplerParameter)
+    {
+        FShaderResourceParameter* TextureParamRes(TextureSlots[TextureSlot]);
+        FShaderResourceParameter* SamplerParamRes(SamplerSlots[SamplerSlot]);
+
+        if (TextureParamRes && SamplerParamRes && TextureParamRes->IsBound())
+        {
+            SetTextureTyped(RHICmdList, *TextureParamRes, *SamplerParamRes, TextureParameter, SamplerParameter);
+        }
+    }
+
+    void BindSRV(FRHICommandList& RHICmdList, int32 SRVSlot, FShaderResourceViewRHIParamRef SRVParameter)
+    {
+        FShaderResourceParameter* Parameter(SRVSlots[SRVSlot]);
+
+        if (Parameter && Parameter->IsBound())
+        {
+            SetSRVTyped(RHICmdList, Parameter->GetBaseIndex(), SRVParameter);
+        }
+    }
+
+    void BindUAV(FRHICommandList& RHICmdList, int32 UAVSlot, FUnorderedAccessViewRHIParamRef UAVParameter)
+    {
+        FShaderResourceParameter* Parameter(UAVSlots[UAVSlot]);
+
+        if (Parameter && Parameter->IsBound())
+        {
+            SetUAVTyped(RHICmdList, Parameter->GetBaseIndex(), UAVParameter);
+        }
+    }
+
+    template<typename FParameterType>
+    void SetParameter(FRHICommandList& RHICmdList, int32 ParameterSlot, FParameterType ParameterValue)
+    {
+        FShaderParameter* Parameter(ParameterSlots[ParameterSlot]);
+
+        if (Parameter && Parameter->IsBound())
         {
-            FShaderResourceParameter* Parameter(ResourcePair.Value.Value);
+            SetShaderValueTyped(RHICmdList, *Parameter, ParameterValue);
+        }
+    }
 
+    void UnbindBuffers(FRHICommandList& RHICmdList)
+    {
+        for (FShaderResourceParameter* Parameter : TextureSlots)
+        {
             if (Parameter && Parameter->IsBound())
             {
                 SetTextureTyped(RHICmdList, *Parameter, FTextureRHIParamRef());
             }
         }
 
-        for (auto& ResourcePair : SRVMap)
+        for (FShaderResourceParameter* Parameter : SRVSlots)
         {
-            FShaderResourceParameter* Parameter(ResourcePair.Value.Value);
-
             if (Parameter && Parameter->IsBound())
             {
                 SetSRVTyped(RHICmdList, Parameter->GetBaseIndex(), FShaderResourceViewRHIParamRef());
             }
         }
 
-        for (auto& ResourcePair : UAVMap)
+        for (FShaderResourceParameter* Parameter : UAVSlots)
         {
-            FShaderResourceParameter* Parameter(ResourcePair.Value.Value);
-
             if (Parameter && Parameter->IsBound())
             {
                 SetUAVTyped(RHICmdList, Parameter->GetBaseIndex(), FUnorderedAccessViewRHIParamRef());
@@ -451,12 +523,24 @@ protected:
     typedef TMap<FName, FResourceId>  FResourceMapType;
     typedef TMap<FName, FParameterId> FParameterMapType;
 
+    typedef TArray<FShaderResourceParameter*, TInlineAllocator<4>> FResourceSlotArrayType;
+    typedef TArray<FShaderParameter*, TInlineAllocator<4>>         FParameterSlotArrayType;
+
     FResourceMapType  TextureMap;
     FResourceMapType  SamplerMap;
     FResourceMapType  SRVMap;
     FResourceMapType  UAVMap;
     FParameterMapType ParameterMap;
 
+    // Parameters in declaration order, indexed by the Slot_ enums
+    // generated by RUL_DECLARE_SHADER_PARAMETERS_N
+
+    FResourceSlotArrayType  TextureSlots;
+    FResourceSlotArrayType  SamplerSlots;
+    FResourceSlotArrayType  SRVSlots;
+    FResourceSlotArrayType  UAVSlots;
+    FParameterSlotArrayType ParameterSlots;
+
 public:
 
     typedef FMaterialShaderType FRULShaderMetaType;
@@ -530,6 +614,8 @@ public:
     {
         for (FResourceId& Parameter : Parameters)
         {
+            TextureSlots.Emplace(Parameter.Value);
+
             if (Parameter.Value)
             {
                 TextureMap.Emplace(FName(*Parameter.Key), Parameter);
@@ -541,6 +627,8 @@ public:
     {
         for (FResourceId& Parameter : Parameters)
         {
+            SamplerSlots.Emplace(Parameter.Value);
+
             if (Parameter.Value)
             {
                 SamplerMap.Emplace(FName(*Parameter.Key), Parameter);
@@ -552,6 +640,8 @@ public:
     {
         for (FResourceId& Parameter : Parameters)
         {
+            SRVSlots.Emplace(Parameter.Value);
+
             if (Parameter.Value)
             {
                 SRVMap.Emplace(FName(*Parameter.Key), Parameter);
@@ -563,6 +653,8 @@ public:
     {
         for (FResourceId& Parameter : Parameters)
         {
+            UAVSlots.Emplace(Parameter.Value);
+
             if (Parameter.Value)
             {
                 UAVMap.Emplace(FName(*Parameter.Key), Parameter);
@@ -574,6 +666,8 @@ public:
     {
         for (FParameterId& Parameter : Parameters)
         {
+            ParameterSlots.Emplace(Parameter.Value);
+
             if (Parameter.Value)
             {
                 ParameterMap.Emplace(FName(*Parameter.Key), Parameter);
@@ -684,32 +778,82 @@ public:
         }
     }
 
-    void UnbindBuffers(FRHICommandList& RHICmdList)
+    // Slot bindings. Slot indices are the Slot_ enums generated by
+    // RUL_DECLARE_SHADER_PARAMETERS_N, resolved at compile time so binds
+    // skip the name lookup of the FName based functions above.
+
+    void BindTexture(FRHICommandList& RHICmdList, int32 TextureSlot, FTextureRHIParamRef TextureParameter)
     {
-        for (auto& ResourcePair : TextureMap)
+        FShaderResourceParameter* Parameter(TextureSlots[TextureSlot]);
+
+        if (Parameter && Parameter->IsBound())
         {
-            FShaderResourceParameter* Parameter(ResourcePair.Value.Value);
+            SetTextureTyped(RHICmdList, *Parameter, TextureParameter);
+        }
+    }
 
+    void BindTexture(FRHICommandList& RHICmdList, int32 TextureSlot, int32 SamplerSlot, FTextureRHIParamRef TextureParameter, FSamplerStateRHIParamRef SamplerParameter)
+    {
+        FShaderResourceParameter* TextureParamRes(TextureSlots[TextureSlot]);
+        FShaderResourceParameter* SamplerParamRes(SamplerSlots[SamplerSlot]);
+
+        if (TextureParamRes && SamplerParamRes && TextureParamRes->IsBound())
+        {
+            SetTextureTyped(RHICmdList, *TextureParamRes, *SamplerParamRes, TextureParameter, SamplerParameter);
+        }
+    }
+
+    void BindSRV(FRHICommandList& RHICmdList, int32 SRVSlot, FShaderResourceViewRHIParamRef SRVParameter)
+    {
+        FShaderResourceParameter* Parameter(SRVSlots[SRVSlot]);
+
+        if (Parameter && Parameter->IsBound())
+        {
+            SetSRVTyped(RHICmdList, Parameter->GetBaseIndex(), SRVParameter);
+        }
+    }
+
+    void BindUAV(FRHICommandList& RHICmdList, int32 UAVSlot, FUnorderedAccessViewRHIParamRef UAVParameter)
+    {
+        FShaderResourceParameter* Parameter(UAVSlots[UAVSlot]);
+
+        if (Parameter && Parameter->IsBound())
+        {
+            SetUAVTyped(RHICmdList, Parameter->GetBaseIndex(), UAVParameter);
+        }
+    }
+
+    template<typename FParameterType>
+    void SetParameter(FRHICommandList& RHICmdList, int32 ParameterSlot, FParameterType ParameterValue)
+    {
+        FShaderParameter* Parameter(ParameterSlots[ParameterSlot]);
+
+        if (Parameter && Parameter->IsBound())
+        {
+            SetShaderValueTyped(RHICmdList, *Parameter, ParameterValue);
+        }
+    }
+
+    void UnbindBuffers(FRHICommandList& RHICmdList)
+    {
+        for (FShaderResourceParameter* Parameter : TextureSlots)
+        {
             if (Parameter && Parameter->IsBound())
             {
                 SetTextureTyped(RHICmdList, *Parameter, FTextureRHIParamRef());
             }
         }
 
-        for (auto& ResourcePair : SRVMap)
+        for (FShaderResourceParameter* Parameter : SRVSlots)
         {
-            FShaderResourceParameter* Parameter(ResourcePair.Value.Value);
-
             if (Parameter && Parameter->IsBound())
             {
                 SetSRVTyped(RHICmdList, Parameter->GetBaseIndex(), FShaderResourceViewRHIParamRef());
             }
         }
 
-        for (auto& ResourcePair : UAVMap)
+        for (FShaderResourceParameter* Parameter : UAVSlots)
         {
-            FShaderResourceParameter* Parameter(ResourcePair.Value.Value);
-
             if (Parameter && Parameter->IsBound())
             {
                 SetUAVTyped(RHICmdList, Parameter->GetBaseIndex(), FUnorderedAccessViewRHIParamRef());
@@ -790,6 +934,19 @@ public:
         RHICmdList.SetComputeShader(GetComputeShader());
     }
 
+    // Maximum thread group count of a single dispatch dimension
+    const static int32 MAX_DISPATCH_GROUPS = 65535;
+
+    // Wrap linear group count into X and Y dispatch dimensions. Shaders
+    // reconstruct the linear group index as (GroupId.y * DispatchCount.X + GroupId.x).
+    static FIntPoint GetLinearDispatchCount(int32 GroupCount)
+    {
+        FIntPoint DispatchCount;
+        DispatchCount.X = FMath::Clamp(GroupCount, 1, MAX_DISPATCH_GROUPS);
+        DispatchCount.Y = FMath::DivideAndRoundUp(FMath::Max(GroupCount, 1), DispatchCount.X);
+        return DispatchCount;
+    }
+
     FIntPoint GetDispatchCount(FIntPoint Dim) const
     {
         FIntPoint DispatchCount;
@@ -818,6 +975,20 @@ public:
     {
         Dispatch(RHICmdList, DimX, DimY, DimZ, true);
     }
+
+    // Dispatch group counts from GetLinearDispatchCount(), or group counts
+    // read from ArgumentBuffer at ArgumentOffset if an argument buffer is specified
+    void DispatchLinear(FRHICommandList& RHICmdList, const FIntPoint& DispatchCount, FVertexBufferRHIParamRef ArgumentBuffer = nullptr, uint32 ArgumentOffset = 0)
+    {
+        if (ArgumentBuffer)
+        {
+            DispatchIndirectComputeShader(RHICmdList, this, ArgumentBuffer, ArgumentOffset);
+        }
+        else
+        {
+            DispatchComputeShader(RHICmdList, this, DispatchCount.X, DispatchCount.Y, 1);
+        }
+    }
 };
 
 #define RUL_DECLARE_SHADER_CONSTRUCTOR_DEFAULT_STATICS(ClassName, ShaderType, CacheCheck)\
@@ -933,6 +1104,11 @@ public:
     void Serialize##Prefix##Parameters(FArchive& Ar) {}\
 
 #define RUL_DECLARE_SHADER_PARAMETERS_1(Prefix, PropertyType, IdType, N0, V0)\
+    public:\
+    enum E##Prefix##Slot\
+    {\
+        Slot_##V0\
+    };\
     private:\
     PropertyType V0;\
     void MapLocal##Prefix##Parameters()\
@@ -947,6 +1123,12 @@ public:
     }
 
 #define RUL_DECLARE_SHADER_PARAMETERS_2(Prefix, PropertyType, IdType, N0, V0, N1, V1)\
+    public:\
+    enum E##Prefix##Slot\
+    {\
+        Slot_##V0,\
+        Slot_##V1\
+    };\
     private:\
     PropertyType V0;\
     PropertyType V1;\
@@ -964,6 +1146,13 @@ public:
     }
 
 #define RUL_DECLARE_SHADER_PARAMETERS_3(Prefix, PropertyType, IdType, N0, V0, N1, V1, N2, V2)\
+    public:\
+    enum E##Prefix##Slot\
+    {\
+        Slot_##V0,\
+        Slot_##V1,\
+        Slot_##V2\
+    };\
     private:\
     PropertyType V0;\
     PropertyType V1;\
@@ -984,6 +1173,14 @@ public:
     }
 
 #define RUL_DECLARE_SHADER_PARAMETERS_4(Prefix, PropertyType, IdType, N0, V0, N1, V1, N2, V2, N3, V3)\
+    public:\
+    enum E##Prefix##Slot\
+    {\
+        Slot_##V0,\
+        Slot_##V1,\
+        Slot_##V2,\
+        Slot_##V3\
+    };\
     private:\
     PropertyType V0;\
     PropertyType V1;\
@@ -1007,6 +1204,15 @@ public:
     }
 
 #define RUL_DECLARE_SHADER_PARAMETERS_5(Prefix, PropertyType, IdType, N0, V0, N1, V1, N2, V2, N3, V3, N4, V4)\
+    public:\
+    enum E##Prefix##Slot\
+    {\
+        Slot_##V0,\
+        Slot_##V1,\
+        Slot_##V2,\
+        Slot_##V3,\
+        Slot_##V4\
+    };\
     private:\
     PropertyType V0;\
     PropertyType V1;\
@@ -1033,6 +1239,16 @@ public:
     }
 
 #define RUL_DECLARE_SHADER_PARAMETERS_6(Prefix, PropertyType, IdType, N0, V0, N1, V1, N2, V2, N3, V3, N4, V4, N5, V5)\
+    public:\
+    enum E##Prefix##Slot\
+    {\
+        Slot_##V0,\
+        Slot_##V1,\
+        Slot_##V2,\
+        Slot_##V3,\
+        Slot_##V4,\
+        Slot_##V5\
+    };\
     private:\
     PropertyType V0;\
     PropertyType V1;\
@@ -1062,6 +1278,17 @@ public:
     }
 
 #define RUL_DECLARE_SHADER_PARAMETERS_7(Prefix, PropertyType, IdType, N0, V0, N1, V1, N2, V2, N3, V3, N4, V4, N5, V5, N6, V6)\
+    public:\
+    enum E##Prefix##Slot\
+    {\
+        Slot_##V0,\
+        Slot_##V1,\
+        Slot_##V2,\
+        Slot_##V3,\
+        Slot_##V4,\
+        Slot_##V5,\
+        Slot_##V6\
+    };\
     private:\
     PropertyType V0;\
     PropertyType V1;\
@@ -1094,6 +1321,18 @@ public:
     }
 
 #define RUL_DECLARE_SHADER_PARAMETERS_8(Prefix, PropertyType, IdType, N0, V0, N1, V1, N2, V2, N3, V3, N4, V4, N5, V5, N6, V6, N7, V7)\
+    public:\
+    enum E##Prefix##Slot\
+    {\
+        Slot_##V0,\
+        Slot_##V1,\
+        Slot_##V2,\
+        Slot_##V3,\
+        Slot_##V4,\
+        Slot_##V5,\
+        Slot_##V6,\
+        Slot_##V7\
+    };\
     private:\
     PropertyType V0;\
     PropertyType V1;\
@@ -1129,6 +1368,19 @@ public:
     }
 
 #define RUL_DECLARE_SHADER_PARAMETERS_9(Prefix, PropertyType, IdType, N0, V0, N1, V1, N2, V2, N3, V3, N4, V4, N5, V5, N6, V6, N7, V7, N8, V8)\
+    public:\
+    enum E##Prefix##Slot\
+    {\
+        Slot_##V0,\
+        Slot_##V1,\
+        Slot_##V2,\
+        Slot_##V3,\
+        Slot_##V4,\
+        Slot_##V5,\
+        Slot_##V6,\
+        Slot_##V7,\
+        Slot_##V8\
+    };\
     private:\
     PropertyType V0;\
     PropertyType V1;\
@@ -1167,6 +1419,20 @@ public:
     }
 
 #define RUL_DECLARE_SHADER_PARAMETERS_10(Prefix, PropertyType, IdType, N0, V0, N1, V1, N2, V2, N3, V3, N4, V4, N5, V5, N6, V6, N7, V7, N8, V8, N9, V9)\
+    public:\
+    enum E##Prefix##Slot\
+    {\
+        Slot_##V0,\
+        Slot_##V1,\
+        Slot_##V2,\
+        Slot_##V3,\
+        Slot_##V4,\
+        Slot_##V5,\
+        Slot_##V6,\
+        Slot_##V7,\
+        Slot_##V8,\
+        Slot_##V9\
+    };\
     private:\
     PropertyType V0;\
     PropertyType V1;\
@@ -1208,6 +1474,21 @@ public:
     }
 
 #define RUL_DECLARE_SHADER_PARAMETERS_11(Prefix, PropertyType, IdType, N0, V0, N1, V1, N2, V2, N3, V3, N4, V4, N5, V5, N6, V6, N7, V7, N8, V8, N9, V9, N10, V10)\
+    public:\
+    enum E##Prefix##Slot\
+    {\
+        Slot_##V0,\
+        Slot_##V1,\
+        Slot_##V2,\
+        Slot_##V3,\
+        Slot_##V4,\
+        Slot_##V5,\
+        Slot_##V6,\
+        Slot_##V7,\
+        Slot_##V8,\
+        Slot_##V9,\
+        Slot_##V10\
+    };\
     private:\
     PropertyType V0;\
     PropertyType V1;\
@@ -31,6 +31,7 @@
 #include "RHIResources.h"
 #include "Geom/GULGeometryInstanceTypes.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "RHI/RULRetainedGeometry.h"
 #include "Shaders/RULShaderParameters.h"
 #include "RULShaderLibrary.generated.h"
 
@@ -76,15 +77,62 @@ struct RENDERINGUTILITYLIBRARY_API FRULTextureValuesRef
     }
 };
 
+// Handle to geometry retained in GPU buffers, used to draw the same
+// geometry repeatedly without re-uploading vertex and index data.
+USTRUCT(BlueprintType)
+struct RENDERINGUTILITYLIBRARY_API FRULGeometryHandle
+{
+    GENERATED_BODY()
+
+    typedef TSharedPtr<FRULRetainedGeometry, ESPMode::ThreadSafe> FSharedRefType;
+
+    FSharedRefType SharedRef;
+
+    FORCEINLINE bool IsValid() const
+    {
+        return SharedRef.IsValid();
+    }
+};
+
+// Render thread state shared by consecutive operations of a batch.
+// Intermediate swap textures are acquired from the render target pool,
+// reused by operations with matching targets and returned on reset.
+struct RENDERINGUTILITYLIBRARY_API FRULShaderDrawContext
+{
+    TArray<FTexture2DRHIRef> SwapTextures;
+
+    // Set once material uniform expressions of all batched operations are updated
+    bool bUniformExpressionsUpdated = false;
+
+    bool bSystemTexturesInitialized = false;
+
+    ~FRULShaderDrawContext()
+    {
+        Reset();
+    }
+
+    // Returns a cached swap texture compatible with the target texture,
+    // acquires a new one from the render target pool if none is available
+    FTexture2DRHIRef GetSwapTexture(FTexture2DRHIParamRef TargetTexture);
+
+    void Reset();
+};
+
 UCLASS()
 class RENDERINGUTILITYLIBRARY_API URULShaderLibrary : public UBlueprintFunctionLibrary
 {
 	GENERATED_BODY()
 
+    friend struct FRULShaderDrawContext;
+
     static FVertexBufferRHIRef& GetFilterShaderVB();
     static ERenderTargetActions GetRenderTargetActions(FRULShaderDrawConfig DrawConfig);
 
-    static bool IsValidSwapTarget(UTextureRenderTarget2D* RTT0, UTextureRenderTarget2D* RTT1);
+    // Returns whether the first pass of a ping-pong draw does not depend on
+    // existing render target contents and may be written to the swap texture,
+    // true only for opaque blending
+    static bool CanStartOnSwapTarget(FRULShaderDrawConfig DrawConfig);
+
     static bool IsValidSwapTarget_RT(FTexture2DRHIParamRef Tex0, FTexture2DRHIParamRef Tex1);
 
     static void AssignBlendState(FGraphicsPipelineStateInitializer& GraphicsPSOInit, ERULShaderDrawBlendType BlendType);
@@ -101,6 +149,18 @@ class RENDERINGUTILITYLIBRARY_API URULShaderLibrary : public UBlueprintFunctionL
         const FRULShaderDrawConfig& DrawConfig
         );
 
+    // Shared geometry render pass setup, primitives are
+    // submitted by the callback once the pipeline is bound
+    static void DrawGeometryPass_RT(
+        FRHICommandListImmediate& RHICmdList,
+        ERHIFeatureLevel::Type FeatureLevel,
+        FTextureRenderTarget2DResource* RenderTargetResource,
+        const FRULShaderDrawConfig& DrawConfig,
+        FIntPoint DrawSize,
+        bool bUseColorBuffer,
+        TFunctionRef<void(FRHICommandList&)> DrawPrimitives
+        );
+
     static void SetupMaterialParameters(
         FRHICommandListImmediate& RHICmdList,
         ERHIFeatureLevel::Type FeatureLevel,
@@ -110,6 +170,8 @@ class RENDERINGUTILITYLIBRARY_API URULShaderLibrary : public UBlueprintFunctionL
         FSceneView& View
         );
 
+    // Returns the cached default view of the render target,
+    // the view is rebuilt if the render target has been resized or reallocated
     static TSharedRef<FSceneView> CreateDefaultRTView(
         FRHICommandListImmediate& RHICmdList,
         FTextureRenderTarget2DResource* RTResource,
@@ -130,6 +192,12 @@ class RENDERINGUTILITYLIBRARY_API URULShaderLibrary : public UBlueprintFunctionL
 
 public:
 
+    // Returns whether both render targets are valid and share dimension and format
+    static bool IsValidSwapTarget(UTextureRenderTarget2D* RTT0, UTextureRenderTarget2D* RTT1);
+
+    // Releases the cached default view of the render target
+    static void ReleaseCachedRTView_RT(FTextureRenderTarget2DResource* RTResource);
+
     UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="CallbackEvent"))
     static void CopyToResolveTarget(
         UObject* WorldContextObject,
@@ -185,6 +253,42 @@ public:
         const TArray<FColor>* Colors = nullptr
         );
 
+    // Upload geometry once into static GPU buffers.
+    // Colors are optional and only used if the color count matches the vertex count.
+    UFUNCTION(BlueprintCallable, meta=(AutoCreateRefTerm="Colors"))
+    static FRULGeometryHandle CreateGeometryHandle(
+        const TArray<FVector>& Vertices,
+        const TArray<int32>& Indices,
+        const TArray<FColor>& Colors
+        );
+
+    // Release handle geometry buffers once pending draws have been submitted
+    UFUNCTION(BlueprintCallable)
+    static void ReleaseGeometryHandle(UPARAM(ref) FRULGeometryHandle& GeometryHandle);
+
+    UFUNCTION(BlueprintCallable, BlueprintPure)
+    static bool IsValidGeometryHandle(const FRULGeometryHandle& GeometryHandle);
+
+    UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="CallbackEvent"))
+    static void DrawGeometryHandle(
+        UObject* WorldContextObject,
+        UTextureRenderTarget2D* RenderTarget,
+        FRULShaderDrawConfig DrawConfig,
+        FIntPoint DrawSize,
+        const FRULGeometryHandle& GeometryHandle,
+        UGWTTickEvent* CallbackEvent = nullptr
+        );
+
+    // Draw retained geometry to a render target
+    static void DrawGeometryHandle_RT(
+        FRHICommandListImmediate& RHICmdList,
+        ERHIFeatureLevel::Type FeatureLevel,
+        FTextureRenderTarget2DResource* RenderTargetResource,
+        FRULShaderDrawConfig DrawConfig,
+        FIntPoint DrawSize,
+        const FRULRetainedGeometry& Geometry
+        );
+
     UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="CallbackEvent"))
     static void DrawTexture(
         UObject* WorldContextObject,
@@ -199,7 +303,8 @@ public:
         ERHIFeatureLevel::Type FeatureLevel,
         FTexture* SourceTexture,
         FTextureRenderTarget2DResource* RenderTargetResource,
-        FRULShaderDrawConfig DrawConfig
+        FRULShaderDrawConfig DrawConfig,
+        FRULShaderDrawContext* DrawContext = nullptr
         );
 
     UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="CallbackEvent"))
@@ -216,7 +321,8 @@ public:
         ERHIFeatureLevel::Type FeatureLevel,
         FTextureRenderTarget2DResource* RenderTargetResource,
         const FMaterialRenderProxy* MaterialRenderProxy,
-        FRULShaderDrawConfig DrawConfig
+        FRULShaderDrawConfig DrawConfig,
+        FRULShaderDrawContext* DrawContext = nullptr
         );
 
     UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="CallbackEvent"))
@@ -239,7 +345,8 @@ public:
         FRULShaderTextureParameterInputResource SourceTextureResource,
         FTextureRenderTarget2DResource* RenderTargetResource,
         FTextureRenderTarget2DResource* SwapTargetResource,
-        const FMaterialRenderProxy* MaterialRenderProxy
+        const FMaterialRenderProxy* MaterialRenderProxy,
+        FRULShaderDrawContext* DrawContext = nullptr
         );
 
     UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="CallbackEvent"))
@@ -287,6 +394,9 @@ public:
         FRULShaderDrawConfig DrawConfig
         );
 
+    // Maximum number of polygon sides accepted by DrawMaterialPoly()
+    const static int32 MAX_POLY_SIDES = 1024;
+
     UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="CallbackEvent"))
     static void DrawMaterialPoly(
         UObject* WorldContextObject,
@@ -297,6 +407,17 @@ public:
         UGWTTickEvent* CallbackEvent = nullptr
         );
 
+    // Draws polygons as instanced triangle fans generated in the vertex shader
+    static void DrawMaterialPoly_RT(
+        FRHICommandListImmediate& RHICmdList,
+        ERHIFeatureLevel::Type FeatureLevel,
+        const TArray<FGULPolyGeometryInstance>& Polys,
+        FTextureRenderTarget2DResource* RenderTargetResource,
+        const FMaterialRenderProxy* MaterialRenderProxy,
+        FRULShaderDrawConfig DrawConfig
+        );
+
+    // Draws prebuilt polygon triangle list vertices
     static void DrawMaterialPoly_RT(
         FRHICommandListImmediate& RHICmdList,
         ERHIFeatureLevel::Type FeatureLevel,
@@ -328,15 +449,78 @@ public:
         bool bApplyLevelMax
         );
 
-    UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="CallbackEvent"))
+    UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="EdgeMode,CallbackEvent"))
+    static void GaussianBlur(
+        UObject* WorldContextObject,
+        UTexture* SourceTexture,
+        UTextureRenderTarget2D* RenderTarget,
+        float Sigma,
+        ERULShaderBlurEdgeMode EdgeMode = ERULShaderBlurEdgeMode::BEM_Clamp,
+        UGWTTickEvent* CallbackEvent = nullptr
+        );
+
+    static void GaussianBlur_RT(
+        FRHICommandListImmediate& RHICmdList,
+        FTexture* SourceTexture,
+        FTextureRenderTarget2DResource* RenderTargetResource,
+        float Sigma,
+        ERULShaderBlurEdgeMode EdgeMode
+        );
+
+    UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="EdgeMode,CallbackEvent"))
+    static void BoxBlur(
+        UObject* WorldContextObject,
+        UTexture* SourceTexture,
+        UTextureRenderTarget2D* RenderTarget,
+        int32 Radius,
+        ERULShaderBlurEdgeMode EdgeMode = ERULShaderBlurEdgeMode::BEM_Clamp,
+        UGWTTickEvent* CallbackEvent = nullptr
+        );
+
+    static void BoxBlur_RT(
+        FRHICommandListImmediate& RHICmdList,
+        FTexture* SourceTexture,
+        FTextureRenderTarget2DResource* RenderTargetResource,
+        int32 Radius,
+        ERULShaderBlurEdgeMode EdgeMode
+        );
+
+    // Runs IterationCount hydraulic and thermal erosion iterations on the
+    // height map in a single render command. Height map must be an RTF_R32f
+    // render target with dimension of multiple of 16. Simulation state is
+    // shared and continues from the previous call of the same dimension
+    // unless bResetSimulation is set.
+    UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="bResetSimulation,FlowMagnitudeTarget,CallbackEvent"))
+    static void ApplyHeightMapErosion(
+        UObject* WorldContextObject,
+        UTextureRenderTarget2D* HeightMap,
+        int32 IterationCount,
+        FRULShaderErosionConfig Config,
+        bool bResetSimulation = true,
+        UTextureRenderTarget2D* FlowMagnitudeTarget = nullptr,
+        UGWTTickEvent* CallbackEvent = nullptr
+        );
+
+    static void ApplyHeightMapErosion_RT(
+        FRHICommandListImmediate& RHICmdList,
+        FTextureRenderTarget2DResource* HeightMapResource,
+        int32 IterationCount,
+        const FRULShaderErosionConfig& Config,
+        bool bResetSimulation,
+        FTextureRenderTarget2DResource* FlowMagnitudeResource = nullptr
+        );
+
+    UFUNCTION(BlueprintCallable, meta=(AdvancedDisplay="CallbackEvent,bAsyncReadback"))
     static FRULTextureValuesRef GetTextureValuesByPoints(
         UObject* WorldContextObject,
         FRULShaderTextureParameterInput SourceTexture,
         const FVector2D ScaleDimension,
         const TArray<FVector2D>& Points,
-        UGWTTickEvent* CallbackEvent = nullptr
+        UGWTTickEvent* CallbackEvent = nullptr,
+        bool bAsyncReadback = false
         );
 
+    // Samples texture values and blocks the render thread until the values are read back
     static void GetTextureValuesByPoints_RT(
         FRHICommandListImmediate& RHICmdList,
         ERHIFeatureLevel::Type FeatureLevel,
@@ -346,6 +530,18 @@ public:
         FRULTextureValuesRef::FSharedRefType ValuesRef
         );
 
+    // Samples texture values through a fenced staging buffer readback.
+    // Values are written and the callback event fired once the GPU copy completes.
+    static void GetTextureValuesByPointsAsync_RT(
+        FRHICommandListImmediate& RHICmdList,
+        ERHIFeatureLevel::Type FeatureLevel,
+        FRULShaderTextureParameterInputResource TextureResource,
+        const FVector2D ScaleDimension,
+        const TArray<FVector2D>& Points,
+        FRULTextureValuesRef::FSharedRefType ValuesRef,
+        UGWTTickEvent* CallbackEvent = nullptr
+        );
+
     UFUNCTION(BlueprintCallable)
     static void GetTextureValuesOutput(const FRULTextureValuesRef& ValuesRef, TArray<FLinearColor>& Values);
 
@@ -47,6 +47,14 @@ enum class ERULShaderDrawBlendType : uint8
 	DB_SubRev = 5
 };
 
+UENUM(BlueprintType)
+enum class ERULShaderBlurEdgeMode : uint8
+{
+	BEM_Clamp  = 0,
+	BEM_Mirror = 1,
+	BEM_Wrap   = 2
+};
+
 USTRUCT(BlueprintType)
 struct RENDERINGUTILITYLIBRARY_API FRULShaderOutputConfig
 {
@@ -94,6 +102,51 @@ struct RENDERINGUTILITYLIBRARY_API FRULShaderDrawConfig
     bool bClearRenderTarget = false;
 };
 
+USTRUCT(BlueprintType)
+struct RENDERINGUTILITYLIBRARY_API FRULShaderErosionConfig
+{
+    GENERATED_BODY()
+
+    // Water added to every texel per unit of simulation time
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(UIMin=0, ClampMin=0))
+    float SourceAmount = .01f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(UIMin=0, ClampMin=0))
+    float FlowPipeArea = 500.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(UIMin=0.0001, ClampMin=0.0001))
+    float FlowPipeLength = 1.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(UIMin=0, ClampMin=0))
+    float Gravity = 9.81f;
+
+    // Fraction of water retained after every iteration
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(UIMin=0, UIMax=1, ClampMin=0, ClampMax=1))
+    float EvaporationFactor = .985f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(UIMin=0, ClampMin=0))
+    float MinimumTilt = .05f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(UIMin=0, ClampMin=0))
+    float SedimentCapacity = 1.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(UIMin=0, ClampMin=0))
+    float DissolveRate = .5f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(UIMin=0, ClampMin=0))
+    float DepositRate = 1.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bThermalWeathering = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(UIMin=0, ClampMin=0))
+    float ThermalWeatheringAmount = .5f;
+
+    // Minimum height difference between neighbouring texels for thermal weathering to occur
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(UIMin=0, ClampMin=0))
+    float TalusAngle = .01f;
+};
+
 UENUM(BlueprintType)
 enum class ERULShaderTextureType : uint8
 {
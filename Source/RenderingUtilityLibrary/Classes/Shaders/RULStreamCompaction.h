@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHIResources.h"
+#include "RHI/RULRHIBuffer.h"
+
+class FRHICommandListImmediate;
+
+// Stream compaction built on FRULPrefixSumScan.
+//
+// Flags are exclusive scanned into output offsets, elements with non-zero
+// flags are then scattered into a packed output buffer. The survivor count
+// stays on the GPU and is written into an indirect arguments buffer.
+class RENDERINGUTILITYLIBRARY_API FRULStreamCompaction
+{
+public:
+
+    const static int32 BLOCK_SIZE = 128;
+
+    // Number of uint32 values written into the indirect arguments buffer:
+    // dispatch group count (X, 1, 1) followed by the survivor count
+    const static int32 INDIRECT_ARGS_COUNT = 4;
+
+    static bool IsValidDataStride(int32 DataStride)
+    {
+        return DataStride == 4 || DataStride == 8 || DataStride == 16;
+    }
+
+    // Compacts elements of SrcData with non-zero flags into OutputBuffer.
+    //
+    // FlagDataSRV holds one uint per element, flags must be 0 or 1.
+    // OutputBuffer holds ElementCount elements, only the first survivor
+    // count elements are written.
+    // IndirectArgsBuffer receives DivideAndRoundUp(SurvivorCount, IndirectThreadCount)
+    // as dispatch X group count followed by the survivor count at byte offset 12.
+    // OffsetBuffer and SumBuffer are scan scratch buffers, kept by the caller
+    // to be reused across calls.
+    static int32 Compact(
+        FRHICommandListImmediate& RHICmdList,
+        FShaderResourceViewRHIParamRef SrcDataSRV,
+        FShaderResourceViewRHIParamRef FlagDataSRV,
+        int32 DataStride,
+        int32 ElementCount,
+        FRULRWBufferStructured& OutputBuffer,
+        FRULRWBuffer& IndirectArgsBuffer,
+        FRULRWBufferStructured& OffsetBuffer,
+        FRULRWBufferStructured& SumBuffer,
+        int32 IndirectThreadCount = BLOCK_SIZE,
+        uint32 AdditionalOutputUsage = 0
+        );
+};
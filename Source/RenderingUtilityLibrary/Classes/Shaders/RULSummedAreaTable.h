@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHIResources.h"
+#include "RHI/RULRHIBuffer.h"
+
+class FRHICommandListImmediate;
+
+// Summed-area table generation for textures.
+//
+// Table entry (x,y) holds the sum of all source texels within [0,x]x[0,y],
+// the sum of any axis aligned region then takes four table reads.
+// Tables are built with an inclusive row scan followed by an inclusive
+// column scan and stored row major in a structured buffer.
+class RENDERINGUTILITYLIBRARY_API FRULSummedAreaTable
+{
+public:
+
+    enum FSATDataType
+    {
+        // Red channel only
+        SATDT_FLOAT1 = 1,
+        SATDT_FLOAT4 = 4
+    };
+
+    const static int32 BLOCK_SIZE  = 128;
+    const static int32 BLOCK_SIZE2 = 256;
+
+    // Size of a single table entry in bytes. Double-float entries hold a
+    // (hi, lo) pair of the data type, entry value is hi + lo.
+    static int32 GetEntryStride(FSATDataType DataType, bool bDoubleFloat)
+    {
+        return static_cast<int32>(DataType) * sizeof(float) * (bDoubleFloat ? 2 : 1);
+    }
+
+    // Builds the summed-area table of SourceTexture into SATBuffer.
+    //
+    // Double-float entries keep the table exact to roughly 48 bits of
+    // mantissa, use for large textures where float sums lose small values.
+    // Region sums of double-float tables should subtract hi and lo parts
+    // separately before adding them together.
+    // Returns 0 on success or -1 if the inputs are invalid.
+    static int32 Build(
+        FRHICommandListImmediate& RHICmdList,
+        FTextureRHIParamRef SourceTexture,
+        FIntPoint Dimension,
+        FRULRWBufferStructured& SATBuffer,
+        FSATDataType DataType = SATDT_FLOAT4,
+        bool bDoubleFloat = false,
+        uint32 AdditionalOutputUsage = 0
+        );
+
+private:
+
+    template<uint32 DataDimension, uint32 bDoubleFloat>
+    static void BuildTable(
+        FRHICommandListImmediate& RHICmdList,
+        FTextureRHIParamRef SourceTexture,
+        FIntPoint Dimension,
+        FRULRWBufferStructured& SATBuffer
+        );
+};
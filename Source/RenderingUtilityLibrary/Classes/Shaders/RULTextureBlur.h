@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHIResources.h"
+#include "Shaders/RULShaderParameters.h"
+
+class FRHICommandListImmediate;
+
+// Separable texture blur compute kernels.
+//
+// Blurs run one horizontal and one vertical dispatch. Each thread group loads
+// a TILE_SIZE texel row segment plus an apron of the kernel radius on both
+// sides into group shared memory and convolves the segment from there, so
+// every source texel is fetched about once per axis regardless of radius.
+// Both dispatches write their result transposed, the vertical dispatch blurs
+// rows of the transposed intermediate instead of strided columns.
+// Gaussian blurs with radius larger than MAX_RADIUS are split into repeated
+// passes of smaller sigma whose combined variance matches the requested sigma,
+// up to MAX_PASS_COUNT passes after which pass kernels are truncated.
+class RENDERINGUTILITYLIBRARY_API FRULTextureBlur
+{
+public:
+
+    const static int32 TILE_SIZE      = 256;
+    const static int32 MAX_RADIUS     = 128;
+    const static int32 MAX_PASS_COUNT = 8;
+
+    // Kernel radius of a gaussian blur, covers three standard deviations
+    static int32 GetGaussianRadius(float Sigma)
+    {
+        return FMath::CeilToInt(Sigma * 3.f);
+    }
+
+    // Blurs SourceTexture into OutputTexture with a gaussian kernel.
+    //
+    // Source and output textures must have the same dimension. Output texture
+    // is written directly if it was created with TexCreate_UAV, otherwise the
+    // result is written to a pooled texture of the same format and copied.
+    // Returns the number of blur passes or -1 if the inputs are invalid.
+    static int32 GaussianBlur(
+        FRHICommandListImmediate& RHICmdList,
+        FTextureRHIParamRef SourceTexture,
+        FTexture2DRHIParamRef OutputTexture,
+        float Sigma,
+        ERULShaderBlurEdgeMode EdgeMode = ERULShaderBlurEdgeMode::BEM_Clamp
+        );
+
+    // Blurs SourceTexture into OutputTexture with a box kernel of 2*Radius+1 texels.
+    // Radius is limited to MAX_RADIUS.
+    // Returns the number of blur passes or -1 if the inputs are invalid.
+    static int32 BoxBlur(
+        FRHICommandListImmediate& RHICmdList,
+        FTextureRHIParamRef SourceTexture,
+        FTexture2DRHIParamRef OutputTexture,
+        int32 Radius,
+        ERULShaderBlurEdgeMode EdgeMode = ERULShaderBlurEdgeMode::BEM_Clamp
+        );
+
+private:
+
+    // Applies PassCount separable blur passes with the specified half kernel
+    // weights, Weights[0] is the center weight
+    static void Blur(
+        FRHICommandListImmediate& RHICmdList,
+        FTextureRHIParamRef SourceTexture,
+        FTexture2DRHIParamRef OutputTexture,
+        const TArray<float>& Weights,
+        ERULShaderBlurEdgeMode EdgeMode,
+        int32 PassCount
+        );
+};
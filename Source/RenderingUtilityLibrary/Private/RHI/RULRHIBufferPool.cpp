@@ -0,0 +1,182 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "RHI/RULRHIBufferPool.h"
+#include "RenderingUtilityLibrary.h"
+
+#include "RHICommandList.h"
+#include "RHIResources.h"
+
+DECLARE_MEMORY_STAT(TEXT("Pooled Scratch Buffer Memory"), STAT_RULPooledBufferMemory, STATGROUP_RenderingUtilityLibrary);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Scratch Buffer Count"), STAT_RULPooledBufferCount, STATGROUP_RenderingUtilityLibrary);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Scratch Buffer Allocations"), STAT_RULPooledBufferAllocations, STATGROUP_RenderingUtilityLibrary);
+
+static TGlobalResource<FRULRHIBufferPool> GRULRHIBufferPool;
+
+FRULRHIBufferPool::FRULRHIBufferPool()
+    : PooledBytes(0)
+    , MaxPooledBytes(64 * 1024 * 1024)
+    , MaxUnusedFrames(30)
+    , LastTrimFrame(0)
+{
+}
+
+FRULRHIBufferPool& FRULRHIBufferPool::Get()
+{
+    return GRULRHIBufferPool;
+}
+
+void FRULRHIBufferPool::AcquireStructured(
+    FRULRWBufferStructured& OutBuffer,
+    uint32 BytesPerElement,
+    uint32 NumElements,
+    uint32 AdditionalUsage,
+    const TCHAR* InDebugName
+    )
+{
+    check(IsInRenderingThread());
+    check(BytesPerElement > 0);
+
+    OutBuffer.Release();
+
+    const uint32 SizeClass = FPlatformMath::RoundUpToPowerOfTwo(FMath::Max(NumElements, 1u));
+    const uint32 NumBytes  = BytesPerElement * SizeClass;
+
+    // Look for free buffer with matching layout, most recently released first
+
+    for (int32 i=FreeStructuredBuffers.Num()-1; i>=0; --i)
+    {
+        FPooledStructuredBuffer& PooledBuffer(FreeStructuredBuffers[i]);
+
+        if (PooledBuffer.Stride   == BytesPerElement &&
+            PooledBuffer.NumBytes == NumBytes &&
+            PooledBuffer.Usage    == AdditionalUsage)
+        {
+            OutBuffer.Buffer   = PooledBuffer.Buffer;
+            OutBuffer.UAV      = PooledBuffer.UAV;
+            OutBuffer.SRV      = PooledBuffer.SRV;
+            OutBuffer.NumBytes = PooledBuffer.NumBytes;
+
+            RemoveFreeStructuredBuffer(i);
+            return;
+        }
+    }
+
+    // No free buffer available, create a new one
+
+    OutBuffer.Initialize(BytesPerElement, SizeClass, AdditionalUsage, InDebugName);
+
+    INC_DWORD_STAT(STAT_RULPooledBufferAllocations);
+}
+
+void FRULRHIBufferPool::ReleaseStructured(FRULRWBufferStructured& Buffer)
+{
+    check(IsInRenderingThread());
+
+    if (! Buffer.IsValid())
+    {
+        return;
+    }
+
+    FPooledStructuredBuffer PooledBuffer;
+    PooledBuffer.Buffer   = Buffer.Buffer;
+    PooledBuffer.UAV      = Buffer.UAV;
+    PooledBuffer.SRV      = Buffer.SRV;
+    PooledBuffer.Stride   = Buffer.Buffer->GetStride();
+    PooledBuffer.NumBytes = Buffer.NumBytes;
+    PooledBuffer.Usage    = Buffer.Buffer->GetUsage() & ~(BUF_UnorderedAccess | BUF_ShaderResource);
+    PooledBuffer.LastUsedFrame = GFrameNumberRenderThread;
+
+    // Reset the wrapper without discarding the transient resource,
+    // the pool still holds a reference to the buffer
+
+    Buffer.NumBytes = 0;
+    Buffer.Buffer.SafeRelease();
+    Buffer.UAV.SafeRelease();
+    Buffer.SRV.SafeRelease();
+
+    PooledBytes += PooledBuffer.NumBytes;
+    INC_MEMORY_STAT_BY(STAT_RULPooledBufferMemory, PooledBuffer.NumBytes);
+    INC_DWORD_STAT(STAT_RULPooledBufferCount);
+
+    FreeStructuredBuffers.Emplace(MoveTemp(PooledBuffer));
+
+    // Trim once per frame or when the pool exceeds its budget
+
+    if (LastTrimFrame != GFrameNumberRenderThread || PooledBytes > MaxPooledBytes)
+    {
+        Trim();
+    }
+}
+
+void FRULRHIBufferPool::Trim()
+{
+    check(IsInRenderingThread());
+
+    const uint32 CurrentFrame = GFrameNumberRenderThread;
+
+    LastTrimFrame = CurrentFrame;
+
+    // Release buffers that have not been used for a while
+
+    for (int32 i=FreeStructuredBuffers.Num()-1; i>=0; --i)
+    {
+        if ((CurrentFrame - FreeStructuredBuffers[i].LastUsedFrame) > MaxUnusedFrames)
+        {
+            RemoveFreeStructuredBuffer(i);
+        }
+    }
+
+    // Release oldest buffers until the pool fits the budget.
+    // Free buffers are stored in release order, oldest first.
+
+    while (PooledBytes > MaxPooledBytes && FreeStructuredBuffers.Num() > 0)
+    {
+        RemoveFreeStructuredBuffer(0);
+    }
+}
+
+void FRULRHIBufferPool::Empty()
+{
+    while (FreeStructuredBuffers.Num() > 0)
+    {
+        RemoveFreeStructuredBuffer(FreeStructuredBuffers.Num()-1);
+    }
+}
+
+void FRULRHIBufferPool::RemoveFreeStructuredBuffer(int32 Index)
+{
+    const uint32 NumBytes = FreeStructuredBuffers[Index].NumBytes;
+
+    check(PooledBytes >= NumBytes);
+
+    PooledBytes -= NumBytes;
+    DEC_MEMORY_STAT_BY(STAT_RULPooledBufferMemory, NumBytes);
+    DEC_DWORD_STAT(STAT_RULPooledBufferCount);
+
+    FreeStructuredBuffers.RemoveAt(Index, 1, false);
+}
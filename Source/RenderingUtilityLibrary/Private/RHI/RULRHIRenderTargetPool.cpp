@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "RHI/RULRHIRenderTargetPool.h"
+#include "RenderingUtilityLibrary.h"
+
+#include "RenderUtils.h"
+#include "RHICommandList.h"
+#include "RHIResources.h"
+
+DECLARE_MEMORY_STAT(TEXT("Pooled Render Target Memory"), STAT_RULPooledRenderTargetMemory, STATGROUP_RenderingUtilityLibrary);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Render Target Count"), STAT_RULPooledRenderTargetCount, STATGROUP_RenderingUtilityLibrary);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Render Target Allocations"), STAT_RULPooledRenderTargetAllocations, STATGROUP_RenderingUtilityLibrary);
+
+static TGlobalResource<FRULRHIRenderTargetPool> GRULRHIRenderTargetPool;
+
+FRULRHIRenderTargetPool::FRULRHIRenderTargetPool()
+    : PooledBytes(0)
+    , MaxPooledBytes(256 * 1024 * 1024)
+    , MaxUnusedFrames(30)
+    , LastTrimFrame(0)
+{
+}
+
+FRULRHIRenderTargetPool& FRULRHIRenderTargetPool::Get()
+{
+    return GRULRHIRenderTargetPool;
+}
+
+FTexture2DRHIRef FRULRHIRenderTargetPool::Acquire(
+    uint32 SizeX,
+    uint32 SizeY,
+    EPixelFormat Format,
+    uint32 Flags,
+    uint32 TargetableFlags,
+    uint32 NumSamples,
+    const FClearValueBinding& ClearBinding,
+    const TCHAR* InDebugName
+    )
+{
+    check(IsInRenderingThread());
+
+    // Look for free texture with matching description, most recently released first
+
+    for (int32 i=FreeRenderTargets.Num()-1; i>=0; --i)
+    {
+        const FPooledRenderTarget& PooledRenderTarget(FreeRenderTargets[i]);
+
+        if (PooledRenderTarget.SizeX      == SizeX &&
+            PooledRenderTarget.SizeY      == SizeY &&
+            PooledRenderTarget.Format     == Format &&
+            PooledRenderTarget.Flags      == (Flags | TargetableFlags) &&
+            PooledRenderTarget.NumSamples == NumSamples &&
+            PooledRenderTarget.ClearBinding == ClearBinding)
+        {
+            FTexture2DRHIRef Texture = PooledRenderTarget.Texture;
+            RemoveFreeRenderTarget(i);
+            return Texture;
+        }
+    }
+
+    // No free texture available, create a new one
+
+    FTexture2DRHIRef TextureRTV;
+    FTexture2DRHIRef TextureRSV;
+
+    FRHIResourceCreateInfo CreateInfo(ClearBinding);
+    CreateInfo.DebugName = InDebugName;
+
+    RHICreateTargetableShaderResource2D(
+        SizeX,
+        SizeY,
+        Format,
+        1,
+        Flags,
+        TargetableFlags,
+        false,
+        CreateInfo,
+        TextureRTV,
+        TextureRSV,
+        NumSamples
+        );
+
+    INC_DWORD_STAT(STAT_RULPooledRenderTargetAllocations);
+
+    return TextureRTV;
+}
+
+FTexture2DRHIRef FRULRHIRenderTargetPool::AcquireSwapTexture(FTexture2DRHIParamRef TargetTexture)
+{
+    check(TargetTexture != nullptr);
+
+    const uint32 FlagsMask = ~(TexCreate_RenderTargetable | TexCreate_ResolveTargetable | TexCreate_ShaderResource);
+
+    return Acquire(
+        TargetTexture->GetSizeX(),
+        TargetTexture->GetSizeY(),
+        TargetTexture->GetFormat(),
+        TargetTexture->GetFlags() & FlagsMask,
+        TexCreate_RenderTargetable,
+        TargetTexture->GetNumSamples(),
+        TargetTexture->GetClearBinding(),
+        TEXT("RULSwapTexture")
+        );
+}
+
+void FRULRHIRenderTargetPool::Release(FTexture2DRHIRef& Texture)
+{
+    check(IsInRenderingThread());
+
+    if (! Texture.IsValid())
+    {
+        return;
+    }
+
+    FPooledRenderTarget PooledRenderTarget;
+    PooledRenderTarget.Texture      = Texture;
+    PooledRenderTarget.SizeX        = Texture->GetSizeX();
+    PooledRenderTarget.SizeY        = Texture->GetSizeY();
+    PooledRenderTarget.Format       = Texture->GetFormat();
+    PooledRenderTarget.Flags        = Texture->GetFlags() & ~TexCreate_ShaderResource;
+    PooledRenderTarget.NumSamples   = Texture->GetNumSamples();
+    PooledRenderTarget.ClearBinding = Texture->GetClearBinding();
+    PooledRenderTarget.NumBytes     = CalcTextureBytes(Texture);
+    PooledRenderTarget.LastUsedFrame = GFrameNumberRenderThread;
+
+    Texture.SafeRelease();
+
+    PooledBytes += PooledRenderTarget.NumBytes;
+    INC_MEMORY_STAT_BY(STAT_RULPooledRenderTargetMemory, PooledRenderTarget.NumBytes);
+    INC_DWORD_STAT(STAT_RULPooledRenderTargetCount);
+
+    FreeRenderTargets.Emplace(MoveTemp(PooledRenderTarget));
+
+    // Trim once per frame or when the pool exceeds its budget
+
+    if (LastTrimFrame != GFrameNumberRenderThread || PooledBytes > MaxPooledBytes)
+    {
+        Trim();
+    }
+}
+
+void FRULRHIRenderTargetPool::Trim()
+{
+    check(IsInRenderingThread());
+
+    const uint32 CurrentFrame = GFrameNumberRenderThread;
+
+    LastTrimFrame = CurrentFrame;
+
+    // Release textures that have not been used for a while
+
+    for (int32 i=FreeRenderTargets.Num()-1; i>=0; --i)
+    {
+        if ((CurrentFrame - FreeRenderTargets[i].LastUsedFrame) > MaxUnusedFrames)
+        {
+            RemoveFreeRenderTarget(i);
+        }
+    }
+
+    // Release least recently used textures until the pool fits the budget.
+    // Free textures are stored in release order, oldest first.
+
+    while (PooledBytes > MaxPooledBytes && FreeRenderTargets.Num() > 0)
+    {
+        RemoveFreeRenderTarget(0);
+    }
+}
+
+void FRULRHIRenderTargetPool::Empty()
+{
+    while (FreeRenderTargets.Num() > 0)
+    {
+        RemoveFreeRenderTarget(FreeRenderTargets.Num()-1);
+    }
+}
+
+uint64 FRULRHIRenderTargetPool::CalcTextureBytes(FTexture2DRHIParamRef Texture)
+{
+    const uint64 NumBytes = CalcTextureSize(Texture->GetSizeX(), Texture->GetSizeY(), Texture->GetFormat(), 1);
+    return NumBytes * FMath::Max(Texture->GetNumSamples(), 1u);
+}
+
+void FRULRHIRenderTargetPool::RemoveFreeRenderTarget(int32 Index)
+{
+    const uint64 NumBytes = FreeRenderTargets[Index].NumBytes;
+
+    check(PooledBytes >= NumBytes);
+
+    PooledBytes -= NumBytes;
+    DEC_MEMORY_STAT_BY(STAT_RULPooledRenderTargetMemory, NumBytes);
+    DEC_DWORD_STAT(STAT_RULPooledRenderTargetCount);
+
+    FreeRenderTargets.RemoveAt(Index, 1, false);
+}
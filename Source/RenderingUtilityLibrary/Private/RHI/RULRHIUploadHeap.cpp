@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "RHI/RULRHIUploadHeap.h"
+#include "RenderingUtilityLibrary.h"
+
+#include "RHICommandList.h"
+#include "RHIResources.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Upload Heap Allocations"), STAT_RULUploadHeapAllocations, STATGROUP_RenderingUtilityLibrary);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Upload Heap Uploaded Bytes"), STAT_RULUploadHeapUploadedBytes, STATGROUP_RenderingUtilityLibrary);
+
+static FRULRHIUploadHeap GRULRHIUploadHeap;
+
+FRULRHIUploadHeap& FRULRHIUploadHeap::Get()
+{
+    return GRULRHIUploadHeap;
+}
+
+void FRULRHIUploadHeap::UploadVertexData(
+    FRHICommandList& RHICmdList,
+    const void* Data,
+    uint32 NumBytes,
+    FVertexBufferRHIRef& OutBuffer,
+    uint32& OutOffset
+    )
+{
+    check(IsInRenderingThread());
+    check(Data != nullptr);
+
+    INC_DWORD_STAT(STAT_RULUploadHeapAllocations);
+    INC_DWORD_STAT_BY(STAT_RULUploadHeapUploadedBytes, NumBytes);
+
+    FRHIResourceCreateInfo CreateInfo;
+    void* BufferPtr;
+    OutBuffer = RHICreateAndLockVertexBuffer(NumBytes, BUF_Volatile, CreateInfo, BufferPtr);
+    FPlatformMemory::Memcpy(BufferPtr, Data, NumBytes);
+    RHIUnlockVertexBuffer(OutBuffer);
+    OutOffset = 0;
+}
+
+void FRULRHIUploadHeap::UploadIndexData(
+    FRHICommandList& RHICmdList,
+    const void* Data,
+    uint32 NumBytes,
+    uint32 Stride,
+    FIndexBufferRHIRef& OutBuffer,
+    uint32& OutStartIndex
+    )
+{
+    check(IsInRenderingThread());
+    check(Data != nullptr);
+    check(Stride == 2 || Stride == 4);
+
+    INC_DWORD_STAT(STAT_RULUploadHeapAllocations);
+    INC_DWORD_STAT_BY(STAT_RULUploadHeapUploadedBytes, NumBytes);
+
+    FRHIResourceCreateInfo CreateInfo;
+    void* BufferPtr;
+    OutBuffer = RHICreateAndLockIndexBuffer(Stride, NumBytes, BUF_Volatile, CreateInfo, BufferPtr);
+    FPlatformMemory::Memcpy(BufferPtr, Data, NumBytes);
+    RHIUnlockIndexBuffer(OutBuffer);
+    OutStartIndex = 0;
+}
+
+void FRULRHIUploadHeap::UploadTypedData(
+    FRHICommandList& RHICmdList,
+    const FVector4* Data,
+    uint32 NumElements,
+    FShaderResourceViewRHIRef& OutSRV,
+    uint32& OutElementOffset
+    )
+{
+    check(IsInRenderingThread());
+    check(Data != nullptr);
+
+    const uint32 Stride = sizeof(FVector4);
+    const uint32 NumBytes = NumElements * Stride;
+
+    INC_DWORD_STAT(STAT_RULUploadHeapAllocations);
+    INC_DWORD_STAT_BY(STAT_RULUploadHeapUploadedBytes, NumBytes);
+
+    FRHIResourceCreateInfo CreateInfo;
+    void* BufferPtr;
+    FVertexBufferRHIRef Buffer = RHICreateAndLockVertexBuffer(NumBytes, BUF_Volatile | BUF_ShaderResource, CreateInfo, BufferPtr);
+    FPlatformMemory::Memcpy(BufferPtr, Data, NumBytes);
+    RHIUnlockVertexBuffer(Buffer);
+
+    OutSRV = RHICreateShaderResourceView(Buffer, Stride, PF_A32B32G32R32F);
+    OutElementOffset = 0;
+}
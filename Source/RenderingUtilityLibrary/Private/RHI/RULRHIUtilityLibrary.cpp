@@ -26,6 +26,7 @@
 // 
 
 #include "RHI/RULRHIUtilityLibrary.h"
+#include "RHI/RULRHIUploadHeap.h"
 
 #include "RHICommandList.h"
 #include "RHIResources.h"
@@ -52,47 +53,38 @@ void FRULRHIUtilityLibrary::DrawIndexedPrimitiveRaw(
     const uint32 ColorDataSize = ColorDataStride * NumVertices;
     const uint32 IndexDataSize = IndexDataStride * NumIndices;
 
-    // Construct volatile vertex buffer
+    FRULRHIUploadHeap& UploadHeap(FRULRHIUploadHeap::Get());
+
+    // Upload vertex data
 
     FVertexBufferRHIRef VertexBufferRHI;
     {
-        FRHIResourceCreateInfo CreateInfo;
-        void* BufferPtr;
-        VertexBufferRHI = RHICreateAndLockVertexBuffer(VertexDataSize, BUF_Volatile, CreateInfo, BufferPtr);
-        FPlatformMemory::Memcpy(BufferPtr, VertexData, VertexDataSize);
-        RHIUnlockVertexBuffer(VertexBufferRHI);
-        RHICmdList.SetStreamSource(0, VertexBufferRHI, 0);
+        uint32 VertexOffset;
+        UploadHeap.UploadVertexData(RHICmdList, VertexData, VertexDataSize, VertexBufferRHI, VertexOffset);
+        RHICmdList.SetStreamSource(0, VertexBufferRHI, VertexOffset);
     }
 
-    // Construct volatile color buffer
+    // Upload color data
 
     FVertexBufferRHIRef ColorBufferRHI;
     if (ColorData)
     {
-        FRHIResourceCreateInfo CreateInfo;
-        void* BufferPtr;
-        ColorBufferRHI = RHICreateAndLockVertexBuffer(ColorDataSize, BUF_Volatile, CreateInfo, BufferPtr);
-        FPlatformMemory::Memcpy(BufferPtr, ColorData, ColorDataSize);
-        RHIUnlockVertexBuffer(ColorBufferRHI);
-        RHICmdList.SetStreamSource(1, ColorBufferRHI, 0);
+        uint32 ColorOffset;
+        UploadHeap.UploadVertexData(RHICmdList, ColorData, ColorDataSize, ColorBufferRHI, ColorOffset);
+        RHICmdList.SetStreamSource(1, ColorBufferRHI, ColorOffset);
     }
 
-    // Construct volatile index buffer
+    // Upload index data
 
     FIndexBufferRHIRef IndexBufferRHI;
-    {
-        FRHIResourceCreateInfo CreateInfo;
-        void* BufferPtr;
-        IndexBufferRHI = RHICreateAndLockIndexBuffer(IndexDataStride, IndexDataSize, BUF_Volatile, CreateInfo, BufferPtr);
-        FPlatformMemory::Memcpy(BufferPtr, IndexData, IndexDataSize);
-        RHIUnlockIndexBuffer(IndexBufferRHI);
-    }
+    uint32 StartIndex;
+    UploadHeap.UploadIndexData(RHICmdList, IndexData, IndexDataSize, IndexDataStride, IndexBufferRHI, StartIndex);
 
     // Draw primitives
 
-	RHICmdList.DrawIndexedPrimitive(IndexBufferRHI, MinVertexIndex, 0, NumVertices, 0, NumPrimitives, 1);
+	RHICmdList.DrawIndexedPrimitive(IndexBufferRHI, MinVertexIndex, 0, NumVertices, StartIndex, NumPrimitives, 1);
 
-    // Release buffers
+    // Release buffer references
 
 	IndexBufferRHI.SafeRelease();
     ColorBufferRHI.SafeRelease();
@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "RHI/RULRetainedGeometry.h"
+
+#include "RHICommandList.h"
+#include "RHIResources.h"
+
+void FRULRetainedGeometry::Initialize_RT(
+    const TArray<FVector>& Vertices,
+    const TArray<int32>& Indices,
+    const TArray<FColor>* Colors
+    )
+{
+    check(IsInRenderingThread());
+
+    Release_RT();
+
+    if (Vertices.Num() < 3 || Indices.Num() < 3)
+    {
+        return;
+    }
+
+    const uint32 VertexDataSize = Vertices.GetTypeSize() * Vertices.Num();
+    const uint32 IndexDataSize = Indices.GetTypeSize() * Indices.Num();
+
+    // Construct static vertex buffer
+
+    {
+        FRHIResourceCreateInfo CreateInfo;
+        void* BufferPtr;
+        VertexBufferRHI = RHICreateAndLockVertexBuffer(VertexDataSize, BUF_Static, CreateInfo, BufferPtr);
+        FPlatformMemory::Memcpy(BufferPtr, Vertices.GetData(), VertexDataSize);
+        RHIUnlockVertexBuffer(VertexBufferRHI);
+    }
+
+    // Construct static color buffer
+
+    if (Colors && Colors->Num() == Vertices.Num())
+    {
+        const uint32 ColorDataSize = Colors->GetTypeSize() * Colors->Num();
+
+        FRHIResourceCreateInfo CreateInfo;
+        void* BufferPtr;
+        ColorBufferRHI = RHICreateAndLockVertexBuffer(ColorDataSize, BUF_Static, CreateInfo, BufferPtr);
+        FPlatformMemory::Memcpy(BufferPtr, Colors->GetData(), ColorDataSize);
+        RHIUnlockVertexBuffer(ColorBufferRHI);
+    }
+
+    // Construct static index buffer
+
+    {
+        FRHIResourceCreateInfo CreateInfo;
+        void* BufferPtr;
+        IndexBufferRHI = RHICreateAndLockIndexBuffer(Indices.GetTypeSize(), IndexDataSize, BUF_Static, CreateInfo, BufferPtr);
+        FPlatformMemory::Memcpy(BufferPtr, Indices.GetData(), IndexDataSize);
+        RHIUnlockIndexBuffer(IndexBufferRHI);
+    }
+
+    NumVertices = Vertices.Num();
+    NumIndices = Indices.Num();
+}
+
+void FRULRetainedGeometry::Release_RT()
+{
+    IndexBufferRHI.SafeRelease();
+    ColorBufferRHI.SafeRelease();
+    VertexBufferRHI.SafeRelease();
+
+    NumVertices = 0;
+    NumIndices = 0;
+}
+
+void FRULRetainedGeometry::Draw_RT(FRHICommandList& RHICmdList) const
+{
+    check(IsValid());
+
+    RHICmdList.SetStreamSource(0, VertexBufferRHI, 0);
+
+    if (HasColors())
+    {
+        RHICmdList.SetStreamSource(1, ColorBufferRHI, 0);
+    }
+
+    RHICmdList.DrawIndexedPrimitive(IndexBufferRHI, 0, 0, NumVertices, 0, NumIndices/3, 1);
+}
@@ -0,0 +1,508 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "Shaders/RULHeightMapErosion.h"
+
+#include "RHICommandList.h"
+#include "ShaderParameters.h"
+#include "ShaderCore.h"
+
+#include "RenderingUtilityLibrary.h"
+#include "RHI/RULRHIRenderTargetPool.h"
+#include "Shaders/RULShaderDefinitions.h"
+
+// Erosion kernels share a single parameter layout, every kernel type
+// compiles a different entry point of the same shader file
+template<uint32 KernelType>
+class FRULHeightMapErosionCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULHeightMapErosionCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+        OutEnvironment.SetDefine(TEXT("THREAD_SIZE_X"), FRULHeightMapErosion::THREAD_SIZE_X);
+        OutEnvironment.SetDefine(TEXT("THREAD_SIZE_Y"), FRULHeightMapErosion::THREAD_SIZE_Y);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER_WITH_TEXTURE(FRULHeightMapErosionCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        Texture,
+        FShaderResourceParameter,
+        FResourceId,
+        "HeightMap", HeightMap
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_0(Sampler,,)
+
+    RUL_DECLARE_SHADER_PARAMETERS_9(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "DeltaTData",           DeltaTData,
+        "DeltaTScanData",       DeltaTScanData,
+        "WaterMap",             WaterMap,
+        "SedimentMap",          SedimentMap,
+        "SedimentTransferMap",  SedimentTransferMap,
+        "ThermalTransferMapAA", ThermalTransferMapAA,
+        "ThermalTransferMapAX", ThermalTransferMapAX,
+        "FluxMap",              FluxMap,
+        "FlowMap",              FlowMap
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_11(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "OutDeltaTData",           OutDeltaTData,
+        "OutDeltaTScanData",       OutDeltaTScanData,
+        "OutWaterMap",             OutWaterMap,
+        "OutSedimentMap",          OutSedimentMap,
+        "OutSedimentTransferMap",  OutSedimentTransferMap,
+        "OutThermalTransferMapAA", OutThermalTransferMapAA,
+        "OutThermalTransferMapAX", OutThermalTransferMapAX,
+        "OutFluxMap",              OutFluxMap,
+        "OutFlowMap",              OutFlowMap,
+        "OutHeightMap",            OutHeightMap,
+        "OutFlowMagMap",           OutFlowMagMap
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_8(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_Dim",                        Params_Dim,
+        "_DispatchCount",              Params_DispatchCount,
+        "_DeltaTId",                   Params_DeltaTId,
+        "_ScanElementCount",           Params_ScanElementCount,
+        "_SourceAmount",               Params_SourceAmount,
+        "_ThermalWeatheringConstants", Params_ThermalWeatheringConstants,
+        "_FlowConstants",              Params_FlowConstants,
+        "_ErosionConstants",           Params_ErosionConstants
+        )
+};
+
+typedef FRULHeightMapErosionCS<0> FApplyWaterSourcesCS;
+typedef FRULHeightMapErosionCS<1> FComputeFluxCS;
+typedef FRULHeightMapErosionCS<2> FSimulateFlowCS;
+typedef FRULHeightMapErosionCS<3> FSimulateErosionCS;
+typedef FRULHeightMapErosionCS<4> FTransportSedimentCS;
+typedef FRULHeightMapErosionCS<5> FComputeThermalWeatheringCS;
+typedef FRULHeightMapErosionCS<6> FTransferThermalWeatheringCS;
+typedef FRULHeightMapErosionCS<7> FWriteFlowMapMagnitudeCS;
+typedef FRULHeightMapErosionCS<8> FScanDeltaTGroupCS;
+typedef FRULHeightMapErosionCS<9> FScanDeltaTTopLevelCS;
+
+#define SHADER_FILENAME "/Plugin/RenderingUtilityLibrary/Private/PMUHeightMapErosionCS.usf"
+
+IMPLEMENT_SHADER_TYPE(template<>, FApplyWaterSourcesCS,         TEXT(SHADER_FILENAME), TEXT("ApplyWaterSources"),         SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FComputeFluxCS,               TEXT(SHADER_FILENAME), TEXT("ComputeFlux"),               SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FSimulateFlowCS,              TEXT(SHADER_FILENAME), TEXT("SimulateFlow"),              SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FSimulateErosionCS,           TEXT(SHADER_FILENAME), TEXT("SimulateErosion"),           SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FTransportSedimentCS,         TEXT(SHADER_FILENAME), TEXT("TransportSediment"),         SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FComputeThermalWeatheringCS,  TEXT(SHADER_FILENAME), TEXT("ComputeThermalWeathering"),  SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FTransferThermalWeatheringCS, TEXT(SHADER_FILENAME), TEXT("TransferThermalWeathering"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FWriteFlowMapMagnitudeCS,     TEXT(SHADER_FILENAME), TEXT("WriteFlowMapMagnitude"),     SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FScanDeltaTGroupCS,           TEXT(SHADER_FILENAME), TEXT("ScanDeltaTGroup"),           SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FScanDeltaTTopLevelCS,        TEXT(SHADER_FILENAME), TEXT("ScanDeltaTTopLevel"),        SF_Compute);
+
+#undef SHADER_FILENAME
+
+static TGlobalResource<FRULHeightMapErosion> GRULHeightMapErosion;
+
+struct FRULHeightMapErosion::FKernelParameters
+{
+    float SourceAmount;
+    FVector2D ThermalWeatheringConstants;
+    FVector4 FlowConstants;
+    FVector4 ErosionConstants;
+};
+
+FRULHeightMapErosion::FRULHeightMapErosion()
+    : Dimension(0, 0)
+{
+}
+
+FRULHeightMapErosion& FRULHeightMapErosion::Get()
+{
+    return GRULHeightMapErosion;
+}
+
+bool FRULHeightMapErosion::Initialize(FRHICommandListImmediate& RHICmdList, FIntPoint InDimension)
+{
+    check(IsInRenderingThread());
+
+    if (! IsValidDimension(InDimension))
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULHeightMapErosion::Initialize() Invalid dimension (%d, %d), dimension must be a multiple of (%d, %d) with at most %d texels"),
+            InDimension.X,
+            InDimension.Y,
+            THREAD_SIZE_X,
+            THREAD_SIZE_Y,
+            MAX_TEXEL_COUNT
+            );
+        return false;
+    }
+
+    if (Dimension == InDimension)
+    {
+        return true;
+    }
+
+    Release();
+
+    Dimension = InDimension;
+
+    const FIntPoint DispatchCount(GetDispatchCount());
+    const uint32 TexelCount = Dimension.X * Dimension.Y;
+
+    WaterData.Initialize(sizeof(float), TexelCount, PF_R32_FLOAT, BUF_Static, TEXT("RULErosionWaterData"));
+    SedimentData.Initialize(sizeof(float), TexelCount, PF_R32_FLOAT, BUF_Static, TEXT("RULErosionSedimentData"));
+    SedimentTransferData.Initialize(sizeof(float), TexelCount, PF_R32_FLOAT, BUF_Static, TEXT("RULErosionSedimentTransferData"));
+    FluxData.Initialize(sizeof(FVector4), TexelCount, BUF_Static, TEXT("RULErosionFluxData"));
+    FlowData.Initialize(sizeof(FVector2D), TexelCount, BUF_Static, TEXT("RULErosionFlowData"));
+
+    // Per flow group maximum velocity
+    DeltaTScanData.Initialize(sizeof(float), DispatchCount.X * DispatchCount.Y, PF_R32_FLOAT, BUF_Static, TEXT("RULErosionDeltaTScanData"));
+
+    // Per scan group maximum velocity followed by the time step at SCAN_BLOCK_SIZE
+    DeltaTData.Initialize(sizeof(float), SCAN_BLOCK_SIZE+1, PF_R32_FLOAT, BUF_Static, TEXT("RULErosionDeltaTData"));
+
+    // Thermal transfer buffers are only allocated once thermal weathering is used
+
+    ResetState(RHICmdList);
+
+    return true;
+}
+
+void FRULHeightMapErosion::ResetState(FRHICommandListImmediate& RHICmdList)
+{
+    check(IsInRenderingThread());
+
+    if (! IsInitialized())
+    {
+        return;
+    }
+
+    const float InitialDeltaT = MAX_DELTA_T;
+    const uint32 InitialDeltaTBits = *reinterpret_cast<const uint32*>(&InitialDeltaT);
+
+    const uint32 ZeroValues[4] = { 0, 0, 0, 0 };
+    const uint32 DeltaTValues[4] = { InitialDeltaTBits, InitialDeltaTBits, InitialDeltaTBits, InitialDeltaTBits };
+
+    RHICmdList.ClearTinyUAV(WaterData.UAV, ZeroValues);
+    RHICmdList.ClearTinyUAV(SedimentData.UAV, ZeroValues);
+    RHICmdList.ClearTinyUAV(SedimentTransferData.UAV, ZeroValues);
+    RHICmdList.ClearTinyUAV(FluxData.UAV, ZeroValues);
+    RHICmdList.ClearTinyUAV(FlowData.UAV, ZeroValues);
+    RHICmdList.ClearTinyUAV(DeltaTData.UAV, DeltaTValues);
+}
+
+void FRULHeightMapErosion::Release()
+{
+    Dimension = FIntPoint(0, 0);
+
+    WaterData.Release();
+    SedimentData.Release();
+    SedimentTransferData.Release();
+    ThermalTransferDataAA.Release();
+    ThermalTransferDataAX.Release();
+    DeltaTData.Release();
+    DeltaTScanData.Release();
+    FluxData.Release();
+    FlowData.Release();
+}
+
+template<typename FShaderType>
+void FRULHeightMapErosion::DispatchKernel(
+    FRHICommandListImmediate& RHICmdList,
+    const FKernelParameters& Parameters,
+    FTextureRHIParamRef HeightTexture,
+    FUnorderedAccessViewRHIParamRef TextureUAV,
+    FIntPoint GroupCount,
+    uint32 ScanElementCount
+    )
+{
+    TShaderMapRef<FShaderType> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+    // Only parameters referenced by the kernel entry point are bound,
+    // no kernel reads and writes the same buffer through different views.
+    // Texture UAV is the output of both OutHeightMap and OutFlowMagMap,
+    // kernels write to at most one of them.
+
+    ComputeShader->SetShader(RHICmdList);
+    ComputeShader->BindTexture(RHICmdList, FShaderType::Slot_HeightMap, HeightTexture);
+    ComputeShader->BindSRV(RHICmdList, FShaderType::Slot_DeltaTData, DeltaTData.SRV);
+    ComputeShader->BindSRV(RHICmdList, FShaderType::Slot_DeltaTScanData, DeltaTScanData.SRV);
+    ComputeShader->BindSRV(RHICmdList, FShaderType::Slot_WaterMap, WaterData.SRV);
+    ComputeShader->BindSRV(RHICmdList, FShaderType::Slot_SedimentMap, SedimentData.SRV);
+    ComputeShader->BindSRV(RHICmdList, FShaderType::Slot_SedimentTransferMap, SedimentTransferData.SRV);
+    ComputeShader->BindSRV(RHICmdList, FShaderType::Slot_ThermalTransferMapAA, ThermalTransferDataAA.SRV);
+    ComputeShader->BindSRV(RHICmdList, FShaderType::Slot_ThermalTransferMapAX, ThermalTransferDataAX.SRV);
+    ComputeShader->BindSRV(RHICmdList, FShaderType::Slot_FluxMap, FluxData.SRV);
+    ComputeShader->BindSRV(RHICmdList, FShaderType::Slot_FlowMap, FlowData.SRV);
+    ComputeShader->BindUAV(RHICmdList, FShaderType::Slot_OutDeltaTData, DeltaTData.UAV);
+    ComputeShader->BindUAV(RHICmdList, FShaderType::Slot_OutDeltaTScanData, DeltaTScanData.UAV);
+    ComputeShader->BindUAV(RHICmdList, FShaderType::Slot_OutWaterMap, WaterData.UAV);
+    ComputeShader->BindUAV(RHICmdList, FShaderType::Slot_OutSedimentMap, SedimentData.UAV);
+    ComputeShader->BindUAV(RHICmdList, FShaderType::Slot_OutSedimentTransferMap, SedimentTransferData.UAV);
+    ComputeShader->BindUAV(RHICmdList, FShaderType::Slot_OutThermalTransferMapAA, ThermalTransferDataAA.UAV);
+    ComputeShader->BindUAV(RHICmdList, FShaderType::Slot_OutThermalTransferMapAX, ThermalTransferDataAX.UAV);
+    ComputeShader->BindUAV(RHICmdList, FShaderType::Slot_OutFluxMap, FluxData.UAV);
+    ComputeShader->BindUAV(RHICmdList, FShaderType::Slot_OutFlowMap, FlowData.UAV);
+    ComputeShader->BindUAV(RHICmdList, FShaderType::Slot_OutHeightMap, TextureUAV);
+    ComputeShader->BindUAV(RHICmdList, FShaderType::Slot_OutFlowMagMap, TextureUAV);
+    ComputeShader->SetParameter(RHICmdList, FShaderType::Slot_Params_Dim, Dimension);
+    ComputeShader->SetParameter(RHICmdList, FShaderType::Slot_Params_DispatchCount, GetDispatchCount());
+    ComputeShader->SetParameter(RHICmdList, FShaderType::Slot_Params_DeltaTId, static_cast<uint32>(SCAN_BLOCK_SIZE));
+    ComputeShader->SetParameter(RHICmdList, FShaderType::Slot_Params_ScanElementCount, ScanElementCount);
+    ComputeShader->SetParameter(RHICmdList, FShaderType::Slot_Params_SourceAmount, Parameters.SourceAmount);
+    ComputeShader->SetParameter(RHICmdList, FShaderType::Slot_Params_ThermalWeatheringConstants, Parameters.ThermalWeatheringConstants);
+    ComputeShader->SetParameter(RHICmdList, FShaderType::Slot_Params_FlowConstants, Parameters.FlowConstants);
+    ComputeShader->SetParameter(RHICmdList, FShaderType::Slot_Params_ErosionConstants, Parameters.ErosionConstants);
+    DispatchComputeShader(RHICmdList, *ComputeShader, GroupCount.X, GroupCount.Y, 1);
+    ComputeShader->UnbindBuffers(RHICmdList);
+}
+
+int32 FRULHeightMapErosion::Simulate(
+    FRHICommandListImmediate& RHICmdList,
+    FTexture2DRHIParamRef HeightTexture,
+    int32 IterationCount,
+    const FRULShaderErosionConfig& Config
+    )
+{
+    check(IsInRenderingThread());
+
+    if (IterationCount < 1)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULHeightMapErosion::Simulate() Invalid iteration count (%d)"), IterationCount);
+        return -1;
+    }
+
+    if (! HeightTexture || HeightTexture->GetFormat() != PF_R32_FLOAT)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULHeightMapErosion::Simulate() Height texture must be a valid PF_R32_FLOAT texture"));
+        return -1;
+    }
+
+    if (! Initialize(RHICmdList, FIntPoint(HeightTexture->GetSizeX(), HeightTexture->GetSizeY())))
+    {
+        return -1;
+    }
+
+    const bool bThermalWeathering = Config.bThermalWeathering && Config.ThermalWeatheringAmount > 0.f;
+
+    if (bThermalWeathering && ! ThermalTransferDataAA.IsValid())
+    {
+        const uint32 TexelCount = Dimension.X * Dimension.Y;
+        ThermalTransferDataAA.Initialize(sizeof(FVector4), TexelCount, PF_A32B32G32R32F, BUF_Static, TEXT("RULErosionThermalTransferDataAA"));
+        ThermalTransferDataAX.Initialize(sizeof(FVector4), TexelCount, PF_A32B32G32R32F, BUF_Static, TEXT("RULErosionThermalTransferDataAX"));
+    }
+
+    FKernelParameters Parameters;
+    Parameters.SourceAmount = Config.SourceAmount;
+    Parameters.ThermalWeatheringConstants = FVector2D(
+        Config.ThermalWeatheringAmount,
+        Config.TalusAngle
+        );
+    Parameters.FlowConstants = FVector4(
+        Config.FlowPipeArea,
+        FMath::Max(Config.FlowPipeLength, KINDA_SMALL_NUMBER),
+        Config.Gravity,
+        FMath::Clamp(Config.EvaporationFactor, 0.f, 1.f)
+        );
+    Parameters.ErosionConstants = FVector4(
+        Config.MinimumTilt,
+        Config.SedimentCapacity,
+        Config.DissolveRate,
+        Config.DepositRate
+        );
+
+    FRULRHIRenderTargetPool& RenderTargetPool(FRULRHIRenderTargetPool::Get());
+
+    // Simulate on the height texture directly if possible,
+    // otherwise simulate on a pooled copy and copy the result back
+
+    FTexture2DRHIRef SimHeightTexture = HeightTexture;
+
+    if ((HeightTexture->GetFlags() & TexCreate_UAV) == 0)
+    {
+        SimHeightTexture = RenderTargetPool.Acquire(
+            Dimension.X,
+            Dimension.Y,
+            PF_R32_FLOAT,
+            0,
+            TexCreate_RenderTargetable | TexCreate_UAV,
+            1,
+            FClearValueBinding::None,
+            TEXT("RULHeightMapErosionHeight")
+            );
+
+        RHICmdList.CopyToResolveTarget(HeightTexture, SimHeightTexture, FResolveParams());
+    }
+
+    // Thermal weathering reads neighbour heights, weathered heights are
+    // written to a swap texture then transferred back to the height texture
+
+    FTexture2DRHIRef SwapTexture;
+    FUnorderedAccessViewRHIRef SwapUAV;
+
+    if (bThermalWeathering)
+    {
+        SwapTexture = RenderTargetPool.Acquire(
+            Dimension.X,
+            Dimension.Y,
+            PF_R32_FLOAT,
+            0,
+            TexCreate_RenderTargetable | TexCreate_UAV,
+            1,
+            FClearValueBinding::None,
+            TEXT("RULHeightMapErosionSwap")
+            );
+
+        SwapUAV = RHICreateUnorderedAccessView(SwapTexture, 0);
+    }
+
+    FUnorderedAccessViewRHIRef HeightUAV = RHICreateUnorderedAccessView(SimHeightTexture, 0);
+
+    const FIntPoint DispatchCount(GetDispatchCount());
+    const uint32 FlowGroupCount = DispatchCount.X * DispatchCount.Y;
+    const uint32 ScanGroupCount = FMath::DivideAndRoundUp(FlowGroupCount, static_cast<uint32>(SCAN_BLOCK_SIZE));
+
+    RHICmdList.BeginComputePass(TEXT("RULHeightMapErosion"));
+
+    for (int32 Iteration=0; Iteration<IterationCount; ++Iteration)
+    {
+        // Hydraulic erosion
+
+        if (Parameters.SourceAmount > 0.f)
+        {
+            DispatchKernel<FApplyWaterSourcesCS>(RHICmdList, Parameters, nullptr, nullptr, DispatchCount);
+        }
+
+        DispatchKernel<FComputeFluxCS>(RHICmdList, Parameters, SimHeightTexture, nullptr, DispatchCount);
+        DispatchKernel<FSimulateFlowCS>(RHICmdList, Parameters, nullptr, nullptr, DispatchCount);
+        DispatchKernel<FSimulateErosionCS>(RHICmdList, Parameters, nullptr, HeightUAV, DispatchCount);
+        DispatchKernel<FTransportSedimentCS>(RHICmdList, Parameters, nullptr, nullptr, DispatchCount);
+
+        // Thermal weathering
+
+        if (bThermalWeathering)
+        {
+            DispatchKernel<FComputeThermalWeatheringCS>(RHICmdList, Parameters, SimHeightTexture, SwapUAV, DispatchCount);
+            DispatchKernel<FTransferThermalWeatheringCS>(RHICmdList, Parameters, SwapTexture, HeightUAV, DispatchCount);
+        }
+
+        // Reduce maximum flow velocity into the next iteration time step
+
+        DispatchKernel<FScanDeltaTGroupCS>(RHICmdList, Parameters, nullptr, nullptr, FIntPoint(ScanGroupCount, 1), FlowGroupCount);
+        DispatchKernel<FScanDeltaTTopLevelCS>(RHICmdList, Parameters, nullptr, nullptr, FIntPoint(1, 1), ScanGroupCount);
+    }
+
+    RHICmdList.EndComputePass();
+
+    HeightUAV.SafeRelease();
+    SwapUAV.SafeRelease();
+
+    if (SwapTexture.IsValid())
+    {
+        RenderTargetPool.Release(SwapTexture);
+    }
+
+    if (SimHeightTexture != HeightTexture)
+    {
+        RHICmdList.CopyToResolveTarget(SimHeightTexture, HeightTexture, FResolveParams());
+        RenderTargetPool.Release(SimHeightTexture);
+    }
+
+    return IterationCount;
+}
+
+bool FRULHeightMapErosion::WriteFlowMagnitude(FRHICommandListImmediate& RHICmdList, FTexture2DRHIParamRef OutputTexture)
+{
+    check(IsInRenderingThread());
+
+    if (! IsInitialized())
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULHeightMapErosion::WriteFlowMagnitude() Simulation is not initialized"));
+        return false;
+    }
+
+    if (! OutputTexture
+        || OutputTexture->GetFormat() != PF_R32_FLOAT
+        || OutputTexture->GetSizeX() != Dimension.X
+        || OutputTexture->GetSizeY() != Dimension.Y)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULHeightMapErosion::WriteFlowMagnitude() Output texture must be a valid PF_R32_FLOAT texture of the simulation dimension"));
+        return false;
+    }
+
+    FRULRHIRenderTargetPool& RenderTargetPool(FRULRHIRenderTargetPool::Get());
+
+    FTexture2DRHIRef DstTexture = OutputTexture;
+
+    if ((OutputTexture->GetFlags() & TexCreate_UAV) == 0)
+    {
+        DstTexture = RenderTargetPool.Acquire(
+            Dimension.X,
+            Dimension.Y,
+            PF_R32_FLOAT,
+            0,
+            TexCreate_RenderTargetable | TexCreate_UAV,
+            1,
+            OutputTexture->GetClearBinding(),
+            TEXT("RULHeightMapErosionFlowMagnitude")
+            );
+    }
+
+    FUnorderedAccessViewRHIRef DstUAV = RHICreateUnorderedAccessView(DstTexture, 0);
+
+    FKernelParameters Parameters = {};
+
+    RHICmdList.BeginComputePass(TEXT("RULHeightMapErosionFlowMagnitude"));
+    DispatchKernel<FWriteFlowMapMagnitudeCS>(RHICmdList, Parameters, nullptr, DstUAV, GetDispatchCount());
+    RHICmdList.EndComputePass();
+
+    DstUAV.SafeRelease();
+
+    if (DstTexture != OutputTexture)
+    {
+        RHICmdList.CopyToResolveTarget(DstTexture, OutputTexture, FResolveParams());
+        RenderTargetPool.Release(DstTexture);
+    }
+
+    return true;
+}
@@ -0,0 +1,356 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "Shaders/RULOpBatch.h"
+
+#include "Engine/Engine.h"
+#include "Engine/Texture.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInterface.h"
+#include "MaterialShared.h"
+#include "SceneInterface.h"
+#include "TextureResource.h"
+#include "UObject/Package.h"
+
+#include "GWTTickUtilities.h"
+
+#include "RenderingUtilityLibrary.h"
+#include "Shaders/RULShaderLibrary.h"
+
+URULOpBatch* URULOpBatch::CreateOpBatch(UObject* WorldContextObject)
+{
+    UObject* Outer = IsValid(WorldContextObject) ? WorldContextObject : GetTransientPackage();
+    return NewObject<URULOpBatch>(Outer);
+}
+
+void URULOpBatch::AddApplyMaterial(
+    UMaterialInterface* Material,
+    UTextureRenderTarget2D* RenderTarget,
+    FRULShaderDrawConfig DrawConfig
+    )
+{
+    FRULOpBatchEntry Op;
+    Op.Type = ERULOpBatchType::RUL_OBT_ApplyMaterial;
+    Op.Material = Material;
+    Op.RenderTarget = RenderTarget;
+    Op.DrawConfig = DrawConfig;
+    Ops.Emplace(Op);
+}
+
+void URULOpBatch::AddApplyMaterialFilter(
+    UMaterialInterface* Material,
+    int32 RepeatCount,
+    FRULShaderDrawConfig DrawConfig,
+    FRULShaderTextureParameterInput SourceTexture,
+    UTextureRenderTarget2D* RenderTarget,
+    UTextureRenderTarget2D* SwapTarget
+    )
+{
+    if (! SourceTexture.GetResource_GT().HasValidResource())
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULOpBatch::AddApplyMaterialFilter() SKIPPED, INVALID SOURCE TEXTURE"));
+        return;
+    }
+
+    FRULOpBatchEntry Op;
+    Op.Type = ERULOpBatchType::RUL_OBT_ApplyMaterialFilter;
+    Op.Material = Material;
+    Op.RepeatCount = RepeatCount;
+    Op.DrawConfig = DrawConfig;
+    Op.SourceTexture = SourceTexture;
+    Op.RenderTarget = RenderTarget;
+    Op.SwapTarget = SwapTarget;
+    Ops.Emplace(Op);
+}
+
+void URULOpBatch::AddDrawTexture(
+    UTexture* SourceTexture,
+    UTextureRenderTarget2D* RenderTarget,
+    FRULShaderDrawConfig DrawConfig
+    )
+{
+    FRULOpBatchEntry Op;
+    Op.Type = ERULOpBatchType::RUL_OBT_DrawTexture;
+    Op.Texture = SourceTexture;
+    Op.RenderTarget = RenderTarget;
+    Op.DrawConfig = DrawConfig;
+    Ops.Emplace(Op);
+}
+
+void URULOpBatch::AddApplyAutoLevels(
+    UTexture* SourceTexture,
+    UTextureRenderTarget2D* RenderTarget,
+    FRULShaderDrawConfig DrawConfig,
+    bool bApplyLevelMin,
+    bool bApplyLevelMax
+    )
+{
+    FRULOpBatchEntry Op;
+    Op.Type = ERULOpBatchType::RUL_OBT_ApplyAutoLevels;
+    Op.Texture = SourceTexture;
+    Op.RenderTarget = RenderTarget;
+    Op.DrawConfig = DrawConfig;
+    Op.bApplyLevelMin = bApplyLevelMin;
+    Op.bApplyLevelMax = bApplyLevelMax;
+    Ops.Emplace(Op);
+}
+
+void URULOpBatch::Reset()
+{
+    Ops.Reset();
+}
+
+int32 URULOpBatch::GetOpCount() const
+{
+    return Ops.Num();
+}
+
+void URULOpBatch::Execute(UObject* WorldContextObject, UGWTTickEvent* CallbackEvent)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+
+    if (! IsValid(World))
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULOpBatch::Execute() ABORTED, INVALID WORLD CONTEXT OBJECT"));
+        return;
+    }
+
+    if (! World->Scene)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULOpBatch::Execute() ABORTED, INVALID WORLD SCENE"));
+        return;
+    }
+
+    struct FRenderOp
+    {
+        ERULOpBatchType Type;
+        int32 RepeatCount;
+        FRULShaderDrawConfig DrawConfig;
+        FRULShaderTextureParameterInputResource SourceTextureResource;
+        FTexture* SourceTexture;
+        FTextureRenderTarget2DResource* RenderTargetResource;
+        FTextureRenderTarget2DResource* SwapTargetResource;
+        const FMaterialRenderProxy* MaterialRenderProxy;
+        bool bApplyLevelMin;
+        bool bApplyLevelMax;
+    };
+
+    TArray<FRenderOp> RenderOps;
+    RenderOps.Reserve(Ops.Num());
+
+    // Resolve operation render resources, invalid operations are skipped
+
+    for (int32 i=0; i<Ops.Num(); ++i)
+    {
+        const FRULOpBatchEntry& Op(Ops[i]);
+
+        if (! IsValid(Op.RenderTarget))
+        {
+            UE_LOG(LogRUL,Warning, TEXT("URULOpBatch::Execute() SKIPPED OPERATION %d, INVALID RENDER TARGET"), i);
+            continue;
+        }
+
+        FTextureRenderTarget2DResource* RenderTargetResource;
+        RenderTargetResource = static_cast<FTextureRenderTarget2DResource*>(Op.RenderTarget->GameThread_GetRenderTargetResource());
+
+        if (! RenderTargetResource)
+        {
+            UE_LOG(LogRUL,Warning, TEXT("URULOpBatch::Execute() SKIPPED OPERATION %d, INVALID RENDER TARGET TEXTURE RESOURCE"), i);
+            continue;
+        }
+
+        FRenderOp RenderOp = {
+            Op.Type,
+            Op.RepeatCount,
+            Op.DrawConfig,
+            FRULShaderTextureParameterInputResource(),
+            nullptr,
+            RenderTargetResource,
+            nullptr,
+            nullptr,
+            Op.bApplyLevelMin,
+            Op.bApplyLevelMax
+            };
+
+        switch (Op.Type)
+        {
+            case ERULOpBatchType::RUL_OBT_ApplyMaterial:
+            case ERULOpBatchType::RUL_OBT_ApplyMaterialFilter:
+            {
+                if (! IsValid(Op.Material))
+                {
+                    UE_LOG(LogRUL,Warning, TEXT("URULOpBatch::Execute() SKIPPED OPERATION %d, INVALID MATERIAL"), i);
+                    continue;
+                }
+
+                RenderOp.MaterialRenderProxy = Op.Material->GetRenderProxy();
+
+                if (Op.Type == ERULOpBatchType::RUL_OBT_ApplyMaterialFilter)
+                {
+                    RenderOp.SourceTextureResource = Op.SourceTexture.GetResource_GT();
+
+                    // Source texture might have been released since the operation was recorded
+                    if (! RenderOp.SourceTextureResource.HasValidResource())
+                    {
+                        UE_LOG(LogRUL,Warning, TEXT("URULOpBatch::Execute() SKIPPED OPERATION %d, INVALID SOURCE TEXTURE"), i);
+                        continue;
+                    }
+
+                    if (IsValid(Op.SwapTarget))
+                    {
+                        if (URULShaderLibrary::IsValidSwapTarget(Op.RenderTarget, Op.SwapTarget))
+                        {
+                            RenderOp.SwapTargetResource = static_cast<FTextureRenderTarget2DResource*>(Op.SwapTarget->GameThread_GetRenderTargetResource());
+                        }
+                        else
+                        {
+                            UE_LOG(LogRUL,Warning, TEXT("URULOpBatch::Execute() OPERATION %d INVALID SWAP RENDER TARGET DIMENSION / FORMAT"), i);
+                        }
+                    }
+                }
+            }
+            break;
+
+            case ERULOpBatchType::RUL_OBT_DrawTexture:
+            case ERULOpBatchType::RUL_OBT_ApplyAutoLevels:
+            {
+                if (! IsValid(Op.Texture))
+                {
+                    UE_LOG(LogRUL,Warning, TEXT("URULOpBatch::Execute() SKIPPED OPERATION %d, INVALID TEXTURE"), i);
+                    continue;
+                }
+
+                // No level operation specified, silent skip
+                if (Op.Type == ERULOpBatchType::RUL_OBT_ApplyAutoLevels && ! Op.bApplyLevelMin && ! Op.bApplyLevelMax)
+                {
+                    continue;
+                }
+
+                RenderOp.SourceTexture = Op.Texture->Resource;
+            }
+            break;
+        }
+
+        RenderOps.Emplace(RenderOp);
+    }
+
+    Ops.Reset();
+
+    World->SendAllEndOfFrameUpdates();
+
+    struct FRenderParameter
+    {
+        ERHIFeatureLevel::Type FeatureLevel;
+        TArray<FRenderOp> RenderOps;
+        UGWTTickEvent* CallbackEvent;
+    };
+
+    FRenderParameter RenderParameter = {
+        World->Scene->GetFeatureLevel(),
+        MoveTemp(RenderOps),
+        CallbackEvent
+        };
+
+    ENQUEUE_RENDER_COMMAND(RULOpBatch_Execute)(
+        [RenderParameter](FRHICommandListImmediate& RHICmdList)
+        {
+            const ERHIFeatureLevel::Type FeatureLevel = RenderParameter.FeatureLevel;
+            FRULShaderDrawContext DrawContext;
+
+            // Update uniform expressions of all batched materials with a
+            // single deferred expression cache update
+
+            for (const FRenderOp& RenderOp : RenderParameter.RenderOps)
+            {
+                if (RenderOp.MaterialRenderProxy)
+                {
+                    RenderOp.MaterialRenderProxy->UpdateUniformExpressionCacheIfNeeded(FeatureLevel);
+                }
+            }
+
+            FMaterialRenderProxy::UpdateDeferredCachedUniformExpressions();
+            DrawContext.bUniformExpressionsUpdated = true;
+
+            for (const FRenderOp& RenderOp : RenderParameter.RenderOps)
+            {
+                switch (RenderOp.Type)
+                {
+                    case ERULOpBatchType::RUL_OBT_ApplyMaterial:
+                        URULShaderLibrary::ApplyMaterial_RT(
+                            RHICmdList,
+                            FeatureLevel,
+                            RenderOp.RenderTargetResource,
+                            RenderOp.MaterialRenderProxy,
+                            RenderOp.DrawConfig,
+                            &DrawContext
+                            );
+                        break;
+
+                    case ERULOpBatchType::RUL_OBT_ApplyMaterialFilter:
+                        URULShaderLibrary::ApplyMaterialFilter_RT(
+                            RHICmdList,
+                            FeatureLevel,
+                            RenderOp.RepeatCount,
+                            RenderOp.DrawConfig,
+                            RenderOp.SourceTextureResource,
+                            RenderOp.RenderTargetResource,
+                            RenderOp.SwapTargetResource,
+                            RenderOp.MaterialRenderProxy,
+                            &DrawContext
+                            );
+                        break;
+
+                    case ERULOpBatchType::RUL_OBT_DrawTexture:
+                        URULShaderLibrary::DrawTexture_RT(
+                            RHICmdList,
+                            FeatureLevel,
+                            RenderOp.SourceTexture,
+                            RenderOp.RenderTargetResource,
+                            RenderOp.DrawConfig,
+                            &DrawContext
+                            );
+                        break;
+
+                    case ERULOpBatchType::RUL_OBT_ApplyAutoLevels:
+                        URULShaderLibrary::ApplyAutoLevels_RT(
+                            RHICmdList,
+                            FeatureLevel,
+                            RenderOp.SourceTexture,
+                            RenderOp.RenderTargetResource,
+                            RenderOp.DrawConfig,
+                            RenderOp.bApplyLevelMin,
+                            RenderOp.bApplyLevelMax
+                            );
+                        break;
+                }
+            }
+
+            FGWTTickEventRef(RenderParameter.CallbackEvent).EnqueueCallback();
+        }
+    );
+}
@@ -0,0 +1,488 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "Shaders/RULPointSplat.h"
+
+#include "RHIGPUReadback.h"
+#include "ShaderParameters.h"
+#include "ShaderCore.h"
+
+#include "Shaders/RULPrefixSumScan.h"
+#include "Shaders/RULShaderDefinitions.h"
+
+class FRULPointSplatClearTileCountsCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULPointSplatClearTileCountsCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULPointSplatClearTileCountsCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_0(SRV,,)
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "DstTileCounts",  DstTileCounts,
+        "DstBinOverflow", DstBinOverflow
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_TileCount",     Params_TileCount,
+        "_DispatchWidth", Params_DispatchWidth
+        )
+};
+
+class FRULPointSplatCountCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULPointSplatCountCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULPointSplatCountCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "PointData", PointData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "DstTileCounts", DstTileCounts
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_4(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_PointCount",    Params_PointCount,
+        "_TileDimension", Params_TileDimension,
+        "_Dimension",     Params_Dimension,
+        "_DispatchWidth", Params_DispatchWidth
+        )
+};
+
+class FRULPointSplatWriteBinsCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULPointSplatWriteBinsCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULPointSplatWriteBinsCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "PointData", PointData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_3(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "DstTileOffsets", DstTileOffsets,
+        "DstBinData",     DstBinData,
+        "DstBinOverflow", DstBinOverflow
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_5(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_PointCount",    Params_PointCount,
+        "_MaxBinEntries", Params_MaxBinEntries,
+        "_TileDimension", Params_TileDimension,
+        "_Dimension",     Params_Dimension,
+        "_DispatchWidth", Params_DispatchWidth
+        )
+};
+
+template<uint32 BlendMode>
+class FRULPointSplatTileCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULPointSplatTileCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+        OutEnvironment.SetDefine(TEXT("SPLAT_BLEND_MODE"), BlendMode);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULPointSplatTileCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_4(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "PointData",  PointData,
+        "TileCounts", TileCounts,
+        "TileEnds",   TileEnds,
+        "BinData",    BinData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "OutTexture", OutTexture
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_3(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_MaxBinEntries", Params_MaxBinEntries,
+        "_TileDimension", Params_TileDimension,
+        "_Dimension",     Params_Dimension
+        )
+};
+
+#define SHADER_FILENAME "/Plugin/RenderingUtilityLibrary/Private/RULPointSplatCS.usf"
+
+IMPLEMENT_SHADER_TYPE(, FRULPointSplatClearTileCountsCS, TEXT(SHADER_FILENAME), TEXT("ClearTileCountsKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(, FRULPointSplatCountCS, TEXT(SHADER_FILENAME), TEXT("CountKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(, FRULPointSplatWriteBinsCS, TEXT(SHADER_FILENAME), TEXT("WriteBinsKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FRULPointSplatTileCS<1>, TEXT(SHADER_FILENAME), TEXT("SplatTileKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FRULPointSplatTileCS<2>, TEXT(SHADER_FILENAME), TEXT("SplatTileKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FRULPointSplatTileCS<3>, TEXT(SHADER_FILENAME), TEXT("SplatTileKernel"), SF_Compute);
+
+#undef SHADER_FILENAME
+
+FRULPointSplat::FRULPointSplat()
+    : bOverflowReadbackPending(false)
+    , BinCapacity(0)
+{
+}
+
+FRULPointSplat::~FRULPointSplat()
+{
+    Release();
+}
+
+int32 FRULPointSplat::Splat(
+    FRHICommandListImmediate& RHICmdList,
+    FRULRWBufferStructured& PointBuffer,
+    int32 PointCount,
+    FUnorderedAccessViewRHIParamRef OutputTextureUAV,
+    FIntPoint Dimension,
+    ERULShaderDrawBlendType BlendType,
+    int32 MaxBinEntries
+    )
+{
+    check(IsInRenderingThread());
+
+    if (PointCount < 1)
+    {
+        return -1;
+    }
+
+    // Validate inputs
+
+    if (! PointBuffer.IsValid() || PointBuffer.Buffer->GetStride() != sizeof(FVector4) || PointBuffer.GetNumElements() < PointCount)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULPointSplat::Splat() Point buffer must hold at least %d float4 elements"), PointCount);
+        return -1;
+    }
+
+    if (! OutputTextureUAV || Dimension.X < 1 || Dimension.Y < 1)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULPointSplat::Splat() Invalid output texture"));
+        return -1;
+    }
+
+    if (BlendType != ERULShaderDrawBlendType::DB_Max &&
+        BlendType != ERULShaderDrawBlendType::DB_Min &&
+        BlendType != ERULShaderDrawBlendType::DB_Add)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULPointSplat::Splat() Unsupported blend type, only max, min and add are supported"));
+        return -1;
+    }
+
+    const FIntPoint TileDimension(
+        FMath::DivideAndRoundUp(Dimension.X, TILE_SIZE),
+        FMath::DivideAndRoundUp(Dimension.Y, TILE_SIZE)
+        );
+
+    const int32 TileCount = TileDimension.X * TileDimension.Y;
+
+    // Initialize scratch buffers, reuse existing buffers if the layout matches
+
+    if (! TileCountData.HasLayout(sizeof(uint32), TileCount, BUF_Static))
+    {
+        TileCountData.Release();
+        TileCountData.Initialize(sizeof(uint32), TileCount, BUF_Static, TEXT("RULPointSplatTileCountData"));
+    }
+
+    if (! OverflowData.IsValid())
+    {
+        OverflowData.Initialize(sizeof(uint32), 1, PF_R32_UINT, BUF_Static, TEXT("RULPointSplatOverflowData"));
+    }
+
+    // Use the instance bin capacity if no entry limit is specified
+
+    const bool bUseBinCapacity = MaxBinEntries < 1;
+
+    if (bUseBinCapacity)
+    {
+        UpdateBinCapacity(PointCount, TileCount);
+        MaxBinEntries = BinCapacity;
+    }
+
+    // Clear and count tile points
+
+    const FIntPoint TileDispatchCount = FRULPointSplatClearTileCountsCS::GetLinearDispatchCount(FMath::DivideAndRoundUp(TileCount, BLOCK_SIZE));
+    const FIntPoint PointDispatchCount = FRULPointSplatCountCS::GetLinearDispatchCount(FMath::DivideAndRoundUp(PointCount, BLOCK_SIZE));
+
+    RHICmdList.BeginComputePass(TEXT("RULPointSplatCount"));
+    {
+        typedef FRULPointSplatClearTileCountsCS FClearCS;
+
+        TShaderMapRef<FClearCS> ClearCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        ClearCS->SetShader(RHICmdList);
+        ClearCS->BindUAV(RHICmdList, FClearCS::Slot_DstTileCounts, TileCountData.UAV);
+        ClearCS->BindUAV(RHICmdList, FClearCS::Slot_DstBinOverflow, OverflowData.UAV);
+        ClearCS->SetParameter(RHICmdList, FClearCS::Slot_Params_TileCount, TileCount);
+        ClearCS->SetParameter(RHICmdList, FClearCS::Slot_Params_DispatchWidth, TileDispatchCount.X);
+        DispatchComputeShader(RHICmdList, *ClearCS, TileDispatchCount.X, TileDispatchCount.Y, 1);
+        ClearCS->UnbindBuffers(RHICmdList);
+
+        typedef FRULPointSplatCountCS FCountCS;
+
+        TShaderMapRef<FCountCS> CountCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        CountCS->SetShader(RHICmdList);
+        CountCS->BindSRV(RHICmdList, FCountCS::Slot_PointData, PointBuffer.SRV);
+        CountCS->BindUAV(RHICmdList, FCountCS::Slot_DstTileCounts, TileCountData.UAV);
+        CountCS->SetParameter(RHICmdList, FCountCS::Slot_Params_PointCount, PointCount);
+        CountCS->SetParameter(RHICmdList, FCountCS::Slot_Params_TileDimension, TileDimension);
+        CountCS->SetParameter(RHICmdList, FCountCS::Slot_Params_Dimension, Dimension);
+        CountCS->SetParameter(RHICmdList, FCountCS::Slot_Params_DispatchWidth, PointDispatchCount.X);
+        DispatchComputeShader(RHICmdList, *CountCS, PointDispatchCount.X, PointDispatchCount.Y, 1);
+        CountCS->UnbindBuffers(RHICmdList);
+    }
+    RHICmdList.EndComputePass();
+
+    // Tile bin offsets
+
+    const int32 SumIndex = FRULPrefixSumScan::ExclusiveScan<FRULPrefixSumScan::SDT_UINT1>(
+        RHICmdList,
+        TileCountData.SRV,
+        sizeof(uint32),
+        TileCount,
+        TileOffsetData,
+        SumData
+        );
+
+    if (SumIndex < 0)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULPointSplat::Splat() Tile count scan failed"));
+        return -1;
+    }
+
+    if (! BinData.HasLayout(sizeof(uint32), MaxBinEntries, BUF_Static))
+    {
+        BinData.Release();
+        BinData.Initialize(sizeof(uint32), MaxBinEntries, BUF_Static, TEXT("RULPointSplatBinData"));
+    }
+
+    // Write point indices to tile bins
+
+    RHICmdList.BeginComputePass(TEXT("RULPointSplatWriteBins"));
+    {
+        typedef FRULPointSplatWriteBinsCS FWriteBinsCS;
+
+        TShaderMapRef<FWriteBinsCS> WriteBinsCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        WriteBinsCS->SetShader(RHICmdList);
+        WriteBinsCS->BindSRV(RHICmdList, FWriteBinsCS::Slot_PointData, PointBuffer.SRV);
+        WriteBinsCS->BindUAV(RHICmdList, FWriteBinsCS::Slot_DstTileOffsets, TileOffsetData.UAV);
+        WriteBinsCS->BindUAV(RHICmdList, FWriteBinsCS::Slot_DstBinData, BinData.UAV);
+        WriteBinsCS->BindUAV(RHICmdList, FWriteBinsCS::Slot_DstBinOverflow, OverflowData.UAV);
+        WriteBinsCS->SetParameter(RHICmdList, FWriteBinsCS::Slot_Params_PointCount, PointCount);
+        WriteBinsCS->SetParameter(RHICmdList, FWriteBinsCS::Slot_Params_MaxBinEntries, MaxBinEntries);
+        WriteBinsCS->SetParameter(RHICmdList, FWriteBinsCS::Slot_Params_TileDimension, TileDimension);
+        WriteBinsCS->SetParameter(RHICmdList, FWriteBinsCS::Slot_Params_Dimension, Dimension);
+        WriteBinsCS->SetParameter(RHICmdList, FWriteBinsCS::Slot_Params_DispatchWidth, PointDispatchCount.X);
+        DispatchComputeShader(RHICmdList, *WriteBinsCS, PointDispatchCount.X, PointDispatchCount.Y, 1);
+        WriteBinsCS->UnbindBuffers(RHICmdList);
+    }
+    RHICmdList.EndComputePass();
+
+    // Read back the overflow count, resolved by a later call.
+    // Only one readback is kept in flight, overflows of calls made while a
+    // readback is pending are picked up by the next readback.
+
+    if (bUseBinCapacity && ! bOverflowReadbackPending)
+    {
+        if (! OverflowReadback.IsValid())
+        {
+            OverflowReadback.Reset(new FRHIGPUBufferReadback(TEXT("RULPointSplatOverflowReadback")));
+        }
+
+        OverflowReadback->EnqueueCopy(RHICmdList, OverflowData.Buffer);
+        bOverflowReadbackPending = true;
+    }
+
+    // Accumulate tiles
+
+    switch (BlendType)
+    {
+        case ERULShaderDrawBlendType::DB_Max:
+            SplatTiles<1>(RHICmdList, PointBuffer, OutputTextureUAV, Dimension, TileDimension, MaxBinEntries);
+            break;
+
+        case ERULShaderDrawBlendType::DB_Min:
+            SplatTiles<2>(RHICmdList, PointBuffer, OutputTextureUAV, Dimension, TileDimension, MaxBinEntries);
+            break;
+
+        case ERULShaderDrawBlendType::DB_Add:
+            SplatTiles<3>(RHICmdList, PointBuffer, OutputTextureUAV, Dimension, TileDimension, MaxBinEntries);
+            break;
+
+        default:
+            checkNoEntry();
+            break;
+    }
+
+    return MaxBinEntries;
+}
+
+void FRULPointSplat::Release()
+{
+    TileCountData.Release();
+    TileOffsetData.Release();
+    SumData.Release();
+    BinData.Release();
+    OverflowData.Release();
+    OverflowReadback.Reset();
+    bOverflowReadbackPending = false;
+}
+
+void FRULPointSplat::UpdateBinCapacity(int32 PointCount, int32 TileCount)
+{
+    // Grow bin capacity to the entry count required by a previous overflowing call
+
+    if (bOverflowReadbackPending && OverflowReadback->IsReady())
+    {
+        const uint32* OverflowDataPtr = reinterpret_cast<const uint32*>(OverflowReadback->Lock(sizeof(uint32)));
+        const int64 RequiredEntries = *OverflowDataPtr;
+        OverflowReadback->Unlock();
+
+        bOverflowReadbackPending = false;
+
+        if (RequiredEntries > BinCapacity)
+        {
+            // Over-allocate to avoid repeated overflows on slowly growing inputs
+            BinCapacity = static_cast<int32>(FMath::Min<int64>(RequiredEntries + RequiredEntries/4, MAX_int32));
+        }
+    }
+
+    // Initial capacity estimate, assumes points overlap a few tiles on average
+
+    if (BinCapacity < 1)
+    {
+        BinCapacity = static_cast<int32>(FMath::Min<int64>(FMath::Max<int64>(int64(PointCount) * 4, TileCount), MAX_int32));
+    }
+}
+
+template<uint32 BlendMode>
+void FRULPointSplat::SplatTiles(
+    FRHICommandListImmediate& RHICmdList,
+    FRULRWBufferStructured& PointBuffer,
+    FUnorderedAccessViewRHIParamRef OutputTextureUAV,
+    FIntPoint Dimension,
+    FIntPoint TileDimension,
+    int32 MaxBinEntries
+    )
+{
+    typedef FRULPointSplatTileCS<BlendMode> FTileCS;
+
+    RHICmdList.BeginComputePass(TEXT("RULPointSplatTiles"));
+    {
+        TShaderMapRef<FTileCS> TileCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        TileCS->SetShader(RHICmdList);
+        TileCS->BindSRV(RHICmdList, FTileCS::Slot_PointData, PointBuffer.SRV);
+        TileCS->BindSRV(RHICmdList, FTileCS::Slot_TileCounts, TileCountData.SRV);
+        TileCS->BindSRV(RHICmdList, FTileCS::Slot_TileEnds, TileOffsetData.SRV);
+        TileCS->BindSRV(RHICmdList, FTileCS::Slot_BinData, BinData.SRV);
+        TileCS->BindUAV(RHICmdList, FTileCS::Slot_OutTexture, OutputTextureUAV);
+        TileCS->SetParameter(RHICmdList, FTileCS::Slot_Params_MaxBinEntries, MaxBinEntries);
+        TileCS->SetParameter(RHICmdList, FTileCS::Slot_Params_TileDimension, TileDimension);
+        TileCS->SetParameter(RHICmdList, FTileCS::Slot_Params_Dimension, Dimension);
+        DispatchComputeShader(RHICmdList, *TileCS, TileDimension.X, TileDimension.Y, 1);
+        TileCS->UnbindBuffers(RHICmdList);
+    }
+    RHICmdList.EndComputePass();
+}
@@ -32,9 +32,10 @@
 #include "UniformBuffer.h"
 
 #include "RHI/RULAlignedTypes.h"
+#include "RHI/RULRHIBufferPool.h"
 #include "Shaders/RULShaderDefinitions.h"
 
-template<uint32 ScanDimension, uint32 bUseSrc>
+template<uint32 ScanDataType, uint32 bUseSrc, uint32 bInclusive, uint32 bIndirectCount>
 class FRULPrefixSumLocalScanCS : public FRULBaseComputeShader<>
 {
     typedef FRULBaseComputeShader<> FBaseType;
@@ -50,17 +51,20 @@ class FRULPrefixSumLocalScanCS : public FRULBaseComputeShader<>
     {
         FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
         OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
-        OutEnvironment.SetDefine(TEXT("data_t"), FRULPrefixSumScan::GetScanDimensionName<ScanDimension>());
+        OutEnvironment.SetDefine(TEXT("data_t"), *FRULPrefixSumScan::GetScanDataTypeName<ScanDataType>());
         OutEnvironment.SetDefine(TEXT("LOCAL_SCAN_USE_SRC"), bUseSrc);
+        OutEnvironment.SetDefine(TEXT("LOCAL_SCAN_INCLUSIVE"), bInclusive);
+        OutEnvironment.SetDefine(TEXT("SCAN_INDIRECT_COUNT"), bIndirectCount);
     }
 
     RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULPrefixSumLocalScanCS)
 
-    RUL_DECLARE_SHADER_PARAMETERS_1(
+    RUL_DECLARE_SHADER_PARAMETERS_2(
         SRV,
         FShaderResourceParameter,
         FResourceId,
-        "SrcData", SrcData
+        "SrcData",        SrcData,
+        "LevelCountData", LevelCountData
         )
 
     RUL_DECLARE_SHADER_PARAMETERS_2(
@@ -71,15 +75,17 @@ class FRULPrefixSumLocalScanCS : public FRULBaseComputeShader<>
         "SumData", SumData
         )
 
-    RUL_DECLARE_SHADER_PARAMETERS_1(
+    RUL_DECLARE_SHADER_PARAMETERS_3(
         Value,
         FShaderParameter,
         FParameterId,
-        "_ElementCount", Params_ElementCount
+        "_ElementCount",  Params_ElementCount,
+        "_DispatchWidth", Params_DispatchWidth,
+        "_LevelIndex",    Params_LevelIndex
         )
 };
 
-template<uint32 ScanDimension, uint32 bAppendSumToData>
+template<uint32 ScanDataType, uint32 bAppendSumToData, uint32 bIndirectCount>
 class FRULPrefixSumTopLevelScanCS : public FRULBaseComputeShader<>
 {
     typedef FRULBaseComputeShader<> FBaseType;
@@ -95,13 +101,19 @@ class FRULPrefixSumTopLevelScanCS : public FRULBaseComputeShader<>
     {
         FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
         OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
-        OutEnvironment.SetDefine(TEXT("data_t"), FRULPrefixSumScan::GetScanDimensionName<ScanDimension>());
+        OutEnvironment.SetDefine(TEXT("data_t"), *FRULPrefixSumScan::GetScanDataTypeName<ScanDataType>());
         OutEnvironment.SetDefine(TEXT("TOP_LEVEL_SCAN_APPEND_SUM_TO_DATA"), bAppendSumToData ? 1 : 0);
+        OutEnvironment.SetDefine(TEXT("SCAN_INDIRECT_COUNT"), bIndirectCount);
     }
 
     RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULPrefixSumTopLevelScanCS)
 
-    RUL_DECLARE_SHADER_PARAMETERS_0(SRV,,)
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "LevelCountData", LevelCountData
+        )
 
     RUL_DECLARE_SHADER_PARAMETERS_2(
         UAV,
@@ -111,17 +123,18 @@ class FRULPrefixSumTopLevelScanCS : public FRULBaseComputeShader<>
         "SumData", SumData
         )
 
-    RUL_DECLARE_SHADER_PARAMETERS_3(
+    RUL_DECLARE_SHADER_PARAMETERS_4(
         Value,
         FShaderParameter,
         FParameterId,
         "_ElementCount",   Params_ElementCount,
         "_BlockCount",     Params_BlockCount,
-        "_ScanBlockCount", Params_ScanBlockCount
+        "_ScanBlockCount", Params_ScanBlockCount,
+        "_LevelIndex",     Params_LevelIndex
         )
 };
 
-template<uint32 ScanDimension>
+template<uint32 ScanDataType, uint32 bIndirectCount>
 class FRULPrefixSumAddOffsetCS : public FRULBaseComputeShader<>
 {
     typedef FRULBaseComputeShader<> FBaseType;
@@ -137,12 +150,18 @@ class FRULPrefixSumAddOffsetCS : public FRULBaseComputeShader<>
     {
         FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
         OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
-        OutEnvironment.SetDefine(TEXT("data_t"), FRULPrefixSumScan::GetScanDimensionName<ScanDimension>());
+        OutEnvironment.SetDefine(TEXT("data_t"), *FRULPrefixSumScan::GetScanDataTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("SCAN_INDIRECT_COUNT"), bIndirectCount);
     }
 
     RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULPrefixSumAddOffsetCS)
 
-    RUL_DECLARE_SHADER_PARAMETERS_0(SRV,,)
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "LevelCountData", LevelCountData
+        )
 
     RUL_DECLARE_SHADER_PARAMETERS_2(
         UAV,
@@ -152,47 +171,174 @@ class FRULPrefixSumAddOffsetCS : public FRULBaseComputeShader<>
         "SumData", SumData
         )
 
+    RUL_DECLARE_SHADER_PARAMETERS_3(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_ElementCount",  Params_ElementCount,
+        "_DispatchWidth", Params_DispatchWidth,
+        "_LevelIndex",    Params_LevelIndex
+        )
+};
+
+class FRULPrefixSumWriteLevelArgsCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULPrefixSumWriteLevelArgsCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULPrefixSumWriteLevelArgsCS)
+
     RUL_DECLARE_SHADER_PARAMETERS_1(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "ElementCountData", ElementCountData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "DstLevelCountData", DstLevelCountData,
+        "DispatchArgs",      DispatchArgs
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_5(
         Value,
         FShaderParameter,
         FParameterId,
-        "_ElementCount", Params_ElementCount
+        "_ElementCountIndex",    Params_ElementCountIndex,
+        "_MaxElementCount",      Params_MaxElementCount,
+        "_LevelCount",           Params_LevelCount,
+        "_ScanDispatchWidths",   Params_ScanDispatchWidths,
+        "_OffsetDispatchWidths", Params_OffsetDispatchWidths
         )
 };
 
 #define SHADER_FILENAME "/Plugin/RenderingUtilityLibrary/Private/RULPrefixSumScanCS.usf"
-#define SCAN_KERNEL1(N,VN)   N<VN>
 #define SCAN_KERNEL2(N,VN,T) N<VN,T>
+#define SCAN_KERNEL3(N,VN,T,U) N<VN,T,U>
+#define SCAN_KERNEL4(N,VN,T,U,V) N<VN,T,U,V>
+
+#define IMPLEMENT_SCAN_COUNT_SHADER(VN,IC) \
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL4(FRULPrefixSumLocalScanCS,VN,0,0,IC), TEXT(SHADER_FILENAME), TEXT("LocalScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL4(FRULPrefixSumLocalScanCS,VN,1,0,IC), TEXT(SHADER_FILENAME), TEXT("LocalScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL4(FRULPrefixSumLocalScanCS,VN,1,1,IC), TEXT(SHADER_FILENAME), TEXT("LocalScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL3(FRULPrefixSumTopLevelScanCS,VN,0,IC), TEXT(SHADER_FILENAME), TEXT("TopLevelScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL3(FRULPrefixSumTopLevelScanCS,VN,1,IC), TEXT(SHADER_FILENAME), TEXT("TopLevelScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULPrefixSumAddOffsetCS,VN,IC), TEXT(SHADER_FILENAME), TEXT("AddOffsetKernel"), SF_Compute);
 
 #define IMPLEMENT_SCAN_SHADER(VN) \
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULPrefixSumLocalScanCS,VN,0), TEXT(SHADER_FILENAME), TEXT("LocalScanKernel"), SF_Compute);\
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULPrefixSumLocalScanCS,VN,1), TEXT(SHADER_FILENAME), TEXT("LocalScanKernel"), SF_Compute);\
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULPrefixSumTopLevelScanCS,VN,0), TEXT(SHADER_FILENAME), TEXT("TopLevelScanKernel"), SF_Compute);\
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULPrefixSumTopLevelScanCS,VN,1), TEXT(SHADER_FILENAME), TEXT("TopLevelScanKernel"), SF_Compute);\
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL1(FRULPrefixSumAddOffsetCS,VN), TEXT(SHADER_FILENAME), TEXT("AddOffsetKernel"), SF_Compute);
+IMPLEMENT_SCAN_COUNT_SHADER(VN,0)\
+IMPLEMENT_SCAN_COUNT_SHADER(VN,1)
+
+IMPLEMENT_SHADER_TYPE(, FRULPrefixSumWriteLevelArgsCS, TEXT(SHADER_FILENAME), TEXT("WriteLevelArgsKernel"), SF_Compute);
 
-IMPLEMENT_SCAN_SHADER(1)
-IMPLEMENT_SCAN_SHADER(2)
-IMPLEMENT_SCAN_SHADER(4)
+IMPLEMENT_SCAN_SHADER(FRULPrefixSumScan::SDT_UINT1)
+IMPLEMENT_SCAN_SHADER(FRULPrefixSumScan::SDT_UINT2)
+IMPLEMENT_SCAN_SHADER(FRULPrefixSumScan::SDT_UINT4)
 
+IMPLEMENT_SCAN_SHADER(FRULPrefixSumScan::SDT_FLOAT1)
+IMPLEMENT_SCAN_SHADER(FRULPrefixSumScan::SDT_FLOAT2)
+IMPLEMENT_SCAN_SHADER(FRULPrefixSumScan::SDT_FLOAT4)
+
+IMPLEMENT_SCAN_SHADER(FRULPrefixSumScan::SDT_INT1)
+IMPLEMENT_SCAN_SHADER(FRULPrefixSumScan::SDT_INT2)
+IMPLEMENT_SCAN_SHADER(FRULPrefixSumScan::SDT_INT4)
+
+#undef IMPLEMENT_SCAN_COUNT_SHADER
 #undef IMPLEMENT_SCAN_SHADER
-#undef SCAN_KERNEL1
 #undef SCAN_KERNEL2
+#undef SCAN_KERNEL3
+#undef SCAN_KERNEL4
 #undef SHADER_FILENAME
 
-template<uint32 ScanDimension>
-int32 FRULPrefixSumScan::ExclusiveScan(
+void FRULPrefixSumScan::WriteLevelDispatchArgs(
+    FRHICommandListImmediate& RHICmdList,
+    FShaderResourceViewRHIParamRef ElementCountSRV,
+    int32 ElementCountIndex,
+    int32 MaxElementCount,
+    FRULRWBufferStructured& LevelCountBuffer,
+    FRULRWBuffer& DispatchArgsBuffer
+    )
+{
+    check(IsInRenderingThread());
+    check(ElementCountSRV != nullptr);
+    check(LevelCountBuffer.IsValidIndex(MAX_BLOCK_LEVELS));
+
+    typedef FRULPrefixSumWriteLevelArgsCS FWriteLevelArgsCS;
+
+    const int32 BlockLevelCount = GetBlockLevelCount(MaxElementCount);
+
+    check(BlockLevelCount > 0);
+
+    // Dispatch widths of the maximum element count levels
+
+    FIntVector4 ScanDispatchWidths(1, 1, 1, 1);
+    FIntVector4 OffsetDispatchWidths(1, 1, 1, 1);
+
+    int32 LevelCount = MaxElementCount;
+
+    for (int32 Level=0; Level<BlockLevelCount; ++Level)
+    {
+        const int32 GroupCount = FMath::DivideAndRoundUp(LevelCount, BLOCK_SIZE2);
+        ScanDispatchWidths[Level]   = FWriteLevelArgsCS::GetLinearDispatchCount(GroupCount).X;
+        OffsetDispatchWidths[Level] = FWriteLevelArgsCS::GetLinearDispatchCount(GroupCount-1).X;
+        LevelCount = GroupCount;
+    }
+
+    // Initialize dispatch arguments buffer, reuse existing buffer if the size matches
+
+    if (DispatchArgsBuffer.NumBytes != LEVEL_ARGS_COUNT * sizeof(uint32))
+    {
+        DispatchArgsBuffer.Release();
+        DispatchArgsBuffer.Initialize(sizeof(uint32), LEVEL_ARGS_COUNT, PF_R32_UINT, BUF_Static | BUF_DrawIndirect);
+    }
+
+    RHICmdList.BeginComputePass(TEXT("RULPrefixSumWriteLevelArgs"));
+    TShaderMapRef<FWriteLevelArgsCS> WriteLevelArgsCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+    WriteLevelArgsCS->SetShader(RHICmdList);
+    WriteLevelArgsCS->BindSRV(RHICmdList, FWriteLevelArgsCS::Slot_ElementCountData, ElementCountSRV);
+    WriteLevelArgsCS->BindUAV(RHICmdList, FWriteLevelArgsCS::Slot_DstLevelCountData, LevelCountBuffer.UAV);
+    WriteLevelArgsCS->BindUAV(RHICmdList, FWriteLevelArgsCS::Slot_DispatchArgs, DispatchArgsBuffer.UAV);
+    WriteLevelArgsCS->SetParameter(RHICmdList, FWriteLevelArgsCS::Slot_Params_ElementCountIndex, ElementCountIndex);
+    WriteLevelArgsCS->SetParameter(RHICmdList, FWriteLevelArgsCS::Slot_Params_MaxElementCount, MaxElementCount);
+    WriteLevelArgsCS->SetParameter(RHICmdList, FWriteLevelArgsCS::Slot_Params_LevelCount, BlockLevelCount);
+    WriteLevelArgsCS->SetParameter(RHICmdList, FWriteLevelArgsCS::Slot_Params_ScanDispatchWidths, ScanDispatchWidths);
+    WriteLevelArgsCS->SetParameter(RHICmdList, FWriteLevelArgsCS::Slot_Params_OffsetDispatchWidths, OffsetDispatchWidths);
+    DispatchComputeShader(RHICmdList, *WriteLevelArgsCS, 1, 1, 1);
+    WriteLevelArgsCS->UnbindBuffers(RHICmdList);
+    RHICmdList.EndComputePass();
+}
+
+template<uint32 ScanDataType, uint32 bInclusive, uint32 bIndirectCount>
+int32 FRULPrefixSumScan::Scan(
     FRHICommandListImmediate& RHICmdList,
     FShaderResourceViewRHIParamRef SrcDataSRV,
     int32 DataStride,
     int32 ElementCount,
     FRULRWBufferStructured& ScanResult,
     FRULRWBufferStructured& SumBuffer,
-    uint32 AdditionalOutputUsage
+    uint32 AdditionalOutputUsage,
+    FShaderResourceViewRHIParamRef ElementCountSRV,
+    int32 ElementCountIndex,
+    FRULRWBuffer* DispatchArgsBuffer
     )
 {
     check(IsInRenderingThread());
-    check(IsValidScanDimension<ScanDimension>());
+    check(IsValidScanDataType<ScanDataType>());
 
     if (ElementCount < 1)
     {
@@ -202,137 +348,205 @@ int32 FRULPrefixSumScan::ExclusiveScan(
     check(IsInRenderingThread());
     check(DataStride > 0);
 
-    int32 BlockCount      = FMath::DivideAndRoundUp(ElementCount, BLOCK_SIZE2);
-    int32 BlockGroupCount = FMath::DivideAndRoundUp(BlockCount, BLOCK_SIZE2);
+    if (DataStride != GetScanDataTypeStride<ScanDataType>())
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULPrefixSumScan::Scan() Data stride (%d) does not match scan data type stride (%d)"),
+            DataStride,
+            GetScanDataTypeStride<ScanDataType>());
+        return -1;
+    }
+
+    if (bIndirectCount && (! ElementCountSRV || ! DispatchArgsBuffer || ElementCountIndex < 0))
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULPrefixSumScan::Scan() Invalid element count buffer"));
+        return -1;
+    }
+
+    const int32 BlockLevelCount = GetBlockLevelCount(ElementCount);
 
-    int32 ScanBlockCount      = FPlatformMath::RoundUpToPowerOfTwo(BlockCount);
-    int32 ScanBlockGroupCount = FPlatformMath::RoundUpToPowerOfTwo(BlockGroupCount);
+    if (BlockLevelCount < 0)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULPrefixSumScan::Scan() Element count (%d) exceeds the supported scan hierarchy"), ElementCount);
+        return -1;
+    }
 
+    int32 BlockCount     = FMath::DivideAndRoundUp(ElementCount, BLOCK_SIZE2);
+    int32 ScanBlockCount = FPlatformMath::RoundUpToPowerOfTwo(BlockCount);
     int32 SumBufferCount = ScanBlockCount + 1;
 
     check(BlockCount > 0);
 
-    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::ExclusiveScan() ElementCount: %d"), ElementCount);
-    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::ExclusiveScan() BlockCount: %d"), BlockCount);
-    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::ExclusiveScan() BlockGroupCount: %d"), BlockGroupCount);
-    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::ExclusiveScan() ScanBlockCount: %d"), ScanBlockCount);
-    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::ExclusiveScan() ScanBlockGroupCount: %d"), ScanBlockGroupCount);
-    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::ExclusiveScan() SumBufferCount: %d"), SumBufferCount);
-    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::ExclusiveScan() BLOCK_SIZE2: %d"), BLOCK_SIZE2);
+    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::Scan() ElementCount: %d"), ElementCount);
+    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::Scan() BlockCount: %d"), BlockCount);
+    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::Scan() BlockLevelCount: %d"), BlockLevelCount);
+    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::Scan() ScanBlockCount: %d"), ScanBlockCount);
+    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::Scan() SumBufferCount: %d"), SumBufferCount);
+    UE_LOG(UntRUL,Warning, TEXT("RULPrefixSumScan::Scan() BLOCK_SIZE2: %d"), BLOCK_SIZE2);
 
     // Clear and initialize output buffers
 
-    // Initialize scan result
+    // Initialize scan result, reuse existing buffer if the layout matches
 
-    ScanResult.Release();
-    ScanResult.Initialize(DataStride, ElementCount, AdditionalOutputUsage);
+    if (! ScanResult.HasLayout(DataStride, ElementCount, AdditionalOutputUsage))
+    {
+        ScanResult.Release();
+        ScanResult.Initialize(DataStride, ElementCount, AdditionalOutputUsage);
+    }
 
-    // Initialize sum buffer
+    // Initialize sum buffer. Kernels only read entries written by earlier
+    // dispatches so existing buffer contents do not need to be cleared.
 
-    SumBuffer.Release();
+    if (! SumBuffer.HasLayout(DataStride, SumBufferCount, AdditionalOutputUsage))
+    {
+        SumBuffer.Release();
+        SumBuffer.Initialize(DataStride, SumBufferCount, AdditionalOutputUsage);
+    }
 
+    typedef FRULPrefixSumLocalScanCS<ScanDataType,1,bInclusive,bIndirectCount> FLocalScanCS;
+    typedef FRULPrefixSumLocalScanCS<ScanDataType,0,0,bIndirectCount>          FBlockScanCS;
+    typedef FRULPrefixSumTopLevelScanCS<ScanDataType,1,bIndirectCount>         FBlockTopLevelScanCS;
+    typedef FRULPrefixSumTopLevelScanCS<ScanDataType,0,bIndirectCount>         FTopLevelScanCS;
+    typedef FRULPrefixSumAddOffsetCS<ScanDataType,bIndirectCount>              FAddOffsetCS;
+
+    // GPU element count, level counts and dispatch arguments are written
+    // on the GPU and sized against the maximum element count levels
+
+    FRULPooledRWBufferStructured LevelCountData;
+    FVertexBufferRHIParamRef ArgumentBuffer = nullptr;
+
+    if (bIndirectCount)
     {
-        TResourceArray<uint8, VERTEXBUFFER_ALIGNMENT> DefaultSumData(false);
-        DefaultSumData.SetNumZeroed(DataStride * SumBufferCount);
-        SumBuffer.Initialize(DataStride, SumBufferCount, &DefaultSumData, AdditionalOutputUsage);
+        LevelCountData.Acquire(sizeof(uint32), MAX_BLOCK_LEVELS+1, BUF_Static);
+        WriteLevelDispatchArgs(RHICmdList, ElementCountSRV, ElementCountIndex, ElementCount, LevelCountData, *DispatchArgsBuffer);
+        ArgumentBuffer = DispatchArgsBuffer->Buffer;
     }
 
-    // Local scan kernel
+    // Scan hierarchy. Level 0 is the scan result, level 1 the sum buffer
+    // and every further level holds the block sums of the level below.
 
-    RHICmdList.BeginComputePass(TEXT("RULPrefixSumLocalScan"));
-    TShaderMapRef<FRULPrefixSumLocalScanCS<ScanDimension,1>> LocalScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-    LocalScanCS->SetShader(RHICmdList);
-    LocalScanCS->BindSRV(RHICmdList, TEXT("SrcData"), SrcDataSRV);
-    LocalScanCS->BindUAV(RHICmdList, TEXT("DstData"), ScanResult.UAV);
-    LocalScanCS->BindUAV(RHICmdList, TEXT("SumData"), SumBuffer.UAV);
-    LocalScanCS->SetParameter(RHICmdList, TEXT("_ElementCount"), ElementCount);
-    DispatchComputeShader(RHICmdList, *LocalScanCS, BlockCount, 1, 1);
-    LocalScanCS->UnbindBuffers(RHICmdList);
-    RHICmdList.EndComputePass();
+    FRULPooledRWBufferStructured BlockSumData[MAX_BLOCK_LEVELS];
+
+    FRULRWBufferStructured* LevelBuffers[MAX_BLOCK_LEVELS+1];
+    int32 LevelCounts[MAX_BLOCK_LEVELS+1];
 
-    if (BlockGroupCount > 1)
+    LevelBuffers[0] = &ScanResult;
+    LevelBuffers[1] = &SumBuffer;
+    LevelCounts[0]  = ElementCount;
+    LevelCounts[1]  = BlockCount;
+
+    for (int32 Level=2; Level<=BlockLevelCount; ++Level)
     {
-        FRULRWBufferStructured BlockSumData;
-        BlockSumData.Initialize(DataStride, (ScanBlockGroupCount+1), BUF_Static);
+        LevelCounts[Level] = FMath::DivideAndRoundUp(LevelCounts[Level-1], BLOCK_SIZE2);
+        BlockSumData[Level-1].Acquire(DataStride, FPlatformMath::RoundUpToPowerOfTwo(LevelCounts[Level])+1, BUF_Static);
+        LevelBuffers[Level] = &BlockSumData[Level-1];
+    }
 
-        // Block sum scan
+    // Local scan kernel
+
+    {
+        const FIntPoint DispatchCount = FLocalScanCS::GetLinearDispatchCount(BlockCount);
 
         RHICmdList.BeginComputePass(TEXT("RULPrefixSumLocalScan"));
-        TShaderMapRef<FRULPrefixSumLocalScanCS<ScanDimension,0>> BlockScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        TShaderMapRef<FLocalScanCS> LocalScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        LocalScanCS->SetShader(RHICmdList);
+        LocalScanCS->BindSRV(RHICmdList, FLocalScanCS::Slot_SrcData, SrcDataSRV);
+        LocalScanCS->BindSRV(RHICmdList, FLocalScanCS::Slot_LevelCountData, LevelCountData.SRV);
+        LocalScanCS->BindUAV(RHICmdList, FLocalScanCS::Slot_DstData, ScanResult.UAV);
+        LocalScanCS->BindUAV(RHICmdList, FLocalScanCS::Slot_SumData, SumBuffer.UAV);
+        LocalScanCS->SetParameter(RHICmdList, FLocalScanCS::Slot_Params_ElementCount, ElementCount);
+        LocalScanCS->SetParameter(RHICmdList, FLocalScanCS::Slot_Params_DispatchWidth, DispatchCount.X);
+        LocalScanCS->SetParameter(RHICmdList, FLocalScanCS::Slot_Params_LevelIndex, 0);
+        LocalScanCS->DispatchLinear(RHICmdList, DispatchCount, ArgumentBuffer, GetScanArgsOffset(0));
+        LocalScanCS->UnbindBuffers(RHICmdList);
+        RHICmdList.EndComputePass();
+    }
+
+    // Block sum scan, in place scan of each level writing block sums into the next level
+
+    for (int32 Level=1; Level<BlockLevelCount; ++Level)
+    {
+        const FIntPoint DispatchCount = FBlockScanCS::GetLinearDispatchCount(LevelCounts[Level+1]);
+
+        RHICmdList.BeginComputePass(TEXT("RULPrefixSumLocalScan"));
+        TShaderMapRef<FBlockScanCS> BlockScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
         BlockScanCS->SetShader(RHICmdList);
-        BlockScanCS->BindUAV(RHICmdList, TEXT("DstData"), SumBuffer.UAV);
-        BlockScanCS->BindUAV(RHICmdList, TEXT("SumData"), BlockSumData.UAV);
-        BlockScanCS->SetParameter(RHICmdList, TEXT("_ElementCount"), ElementCount);
-        DispatchComputeShader(RHICmdList, *BlockScanCS, BlockGroupCount, 1, 1);
+        BlockScanCS->BindSRV(RHICmdList, FBlockScanCS::Slot_LevelCountData, LevelCountData.SRV);
+        BlockScanCS->BindUAV(RHICmdList, FBlockScanCS::Slot_DstData, LevelBuffers[Level]->UAV);
+        BlockScanCS->BindUAV(RHICmdList, FBlockScanCS::Slot_SumData, LevelBuffers[Level+1]->UAV);
+        BlockScanCS->SetParameter(RHICmdList, FBlockScanCS::Slot_Params_ElementCount, LevelCounts[Level]);
+        BlockScanCS->SetParameter(RHICmdList, FBlockScanCS::Slot_Params_DispatchWidth, DispatchCount.X);
+        BlockScanCS->SetParameter(RHICmdList, FBlockScanCS::Slot_Params_LevelIndex, Level);
+        BlockScanCS->DispatchLinear(RHICmdList, DispatchCount, ArgumentBuffer, GetScanArgsOffset(Level));
         BlockScanCS->UnbindBuffers(RHICmdList);
         RHICmdList.EndComputePass();
+    }
 
-        // Block sum top level scan
+    // Top level scan
+
+    const int32 TopLevelCount     = LevelCounts[BlockLevelCount];
+    const int32 TopLevelScanCount = FPlatformMath::RoundUpToPowerOfTwo(TopLevelCount);
+
+    if (BlockLevelCount > 1)
+    {
+        // Block sum top level scan, appends the total sum to the sum buffer
 
         RHICmdList.BeginComputePass(TEXT("RULPrefixSumTopLevelScan"));
-        TShaderMapRef<FRULPrefixSumTopLevelScanCS<ScanDimension,1>> TopLevelScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        TShaderMapRef<FBlockTopLevelScanCS> TopLevelScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
         TopLevelScanCS->SetShader(RHICmdList);
-        TopLevelScanCS->BindUAV(RHICmdList, TEXT("DstData"), SumBuffer.UAV);
-        TopLevelScanCS->BindUAV(RHICmdList, TEXT("SumData"), BlockSumData.UAV);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_ElementCount"),   ScanBlockCount);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_BlockCount"),     BlockGroupCount);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_ScanBlockCount"), ScanBlockGroupCount);
+        TopLevelScanCS->BindSRV(RHICmdList, FBlockTopLevelScanCS::Slot_LevelCountData, LevelCountData.SRV);
+        TopLevelScanCS->BindUAV(RHICmdList, FBlockTopLevelScanCS::Slot_DstData, SumBuffer.UAV);
+        TopLevelScanCS->BindUAV(RHICmdList, FBlockTopLevelScanCS::Slot_SumData, LevelBuffers[BlockLevelCount]->UAV);
+        TopLevelScanCS->SetParameter(RHICmdList, FBlockTopLevelScanCS::Slot_Params_ElementCount,   ScanBlockCount);
+        TopLevelScanCS->SetParameter(RHICmdList, FBlockTopLevelScanCS::Slot_Params_BlockCount,     TopLevelCount);
+        TopLevelScanCS->SetParameter(RHICmdList, FBlockTopLevelScanCS::Slot_Params_ScanBlockCount, TopLevelScanCount);
+        TopLevelScanCS->SetParameter(RHICmdList, FBlockTopLevelScanCS::Slot_Params_LevelIndex,     BlockLevelCount);
         DispatchComputeShader(RHICmdList, *TopLevelScanCS, 1, 1, 1);
         TopLevelScanCS->UnbindBuffers(RHICmdList);
         RHICmdList.EndComputePass();
-
-        // Add block offset
-
-        TShaderMapRef<FRULPrefixSumAddOffsetCS<ScanDimension>> AddOffsetCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-
-        RHICmdList.BeginComputePass(TEXT("RULPrefixSumAddOffset"));
-        AddOffsetCS->SetShader(RHICmdList);
-        AddOffsetCS->BindUAV(RHICmdList, TEXT("DstData"), SumBuffer.UAV);
-        AddOffsetCS->BindUAV(RHICmdList, TEXT("SumData"), BlockSumData.UAV);
-        AddOffsetCS->SetParameter(RHICmdList, TEXT("_ElementCount"), BlockCount);
-        DispatchComputeShader(RHICmdList, *AddOffsetCS, (BlockGroupCount-1), 1, 1);
-        AddOffsetCS->UnbindBuffers(RHICmdList);
-        RHICmdList.EndComputePass();
-
-        RHICmdList.BeginComputePass(TEXT("RULPrefixSumAddOffset"));
-        AddOffsetCS->SetShader(RHICmdList);
-        AddOffsetCS->BindUAV(RHICmdList, TEXT("DstData"), ScanResult.UAV);
-        AddOffsetCS->BindUAV(RHICmdList, TEXT("SumData"), SumBuffer.UAV);
-        AddOffsetCS->SetParameter(RHICmdList, TEXT("_ElementCount"), ElementCount);
-        DispatchComputeShader(RHICmdList, *AddOffsetCS, (BlockCount-1), 1, 1);
-        AddOffsetCS->UnbindBuffers(RHICmdList);
-        RHICmdList.EndComputePass();
     }
     else
     {
-        // Top level scan
-
         RHICmdList.BeginComputePass(TEXT("RULPrefixSumTopLevelScan"));
-        TShaderMapRef<FRULPrefixSumTopLevelScanCS<ScanDimension,0>> TopLevelScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        TShaderMapRef<FTopLevelScanCS> TopLevelScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
         TopLevelScanCS->SetShader(RHICmdList);
-        TopLevelScanCS->BindUAV(RHICmdList, TEXT("DstData"), ScanResult.UAV);
-        TopLevelScanCS->BindUAV(RHICmdList, TEXT("SumData"), SumBuffer.UAV);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_ElementCount"),   0);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_BlockCount"),     BlockCount);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_ScanBlockCount"), ScanBlockCount);
+        TopLevelScanCS->BindSRV(RHICmdList, FTopLevelScanCS::Slot_LevelCountData, LevelCountData.SRV);
+        TopLevelScanCS->BindUAV(RHICmdList, FTopLevelScanCS::Slot_DstData, ScanResult.UAV);
+        TopLevelScanCS->BindUAV(RHICmdList, FTopLevelScanCS::Slot_SumData, SumBuffer.UAV);
+        TopLevelScanCS->SetParameter(RHICmdList, FTopLevelScanCS::Slot_Params_ElementCount,   0);
+        TopLevelScanCS->SetParameter(RHICmdList, FTopLevelScanCS::Slot_Params_BlockCount,     TopLevelCount);
+        TopLevelScanCS->SetParameter(RHICmdList, FTopLevelScanCS::Slot_Params_ScanBlockCount, TopLevelScanCount);
+        TopLevelScanCS->SetParameter(RHICmdList, FTopLevelScanCS::Slot_Params_LevelIndex,     BlockLevelCount);
         DispatchComputeShader(RHICmdList, *TopLevelScanCS, 1, 1, 1);
         TopLevelScanCS->UnbindBuffers(RHICmdList);
         RHICmdList.EndComputePass();
+    }
+
+    // Add block offsets from the top level down to the scan result
 
-        // Add block offset to local scan
+    TShaderMapRef<FAddOffsetCS> AddOffsetCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
 
-        if (BlockCount > 1)
+    for (int32 Level=BlockLevelCount-1; Level>=0; --Level)
+    {
+        const int32 OffsetBlockCount = LevelCounts[Level+1]-1;
+
+        if (OffsetBlockCount < 1)
         {
-            RHICmdList.BeginComputePass(TEXT("RULPrefixSumAddOffset"));
-            TShaderMapRef<FRULPrefixSumAddOffsetCS<ScanDimension>> AddOffsetCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-            AddOffsetCS->SetShader(RHICmdList);
-            AddOffsetCS->BindUAV(RHICmdList, TEXT("DstData"), ScanResult.UAV);
-            AddOffsetCS->BindUAV(RHICmdList, TEXT("SumData"), SumBuffer.UAV);
-            AddOffsetCS->SetParameter(RHICmdList, TEXT("_ElementCount"), ElementCount);
-            DispatchComputeShader(RHICmdList, *AddOffsetCS, (BlockCount-1), 1, 1);
-            AddOffsetCS->UnbindBuffers(RHICmdList);
-            RHICmdList.EndComputePass();
+            continue;
         }
+
+        const FIntPoint DispatchCount = FAddOffsetCS::GetLinearDispatchCount(OffsetBlockCount);
+
+        RHICmdList.BeginComputePass(TEXT("RULPrefixSumAddOffset"));
+        AddOffsetCS->SetShader(RHICmdList);
+        AddOffsetCS->BindSRV(RHICmdList, FAddOffsetCS::Slot_LevelCountData, LevelCountData.SRV);
+        AddOffsetCS->BindUAV(RHICmdList, FAddOffsetCS::Slot_DstData, LevelBuffers[Level]->UAV);
+        AddOffsetCS->BindUAV(RHICmdList, FAddOffsetCS::Slot_SumData, LevelBuffers[Level+1]->UAV);
+        AddOffsetCS->SetParameter(RHICmdList, FAddOffsetCS::Slot_Params_ElementCount, LevelCounts[Level]);
+        AddOffsetCS->SetParameter(RHICmdList, FAddOffsetCS::Slot_Params_DispatchWidth, DispatchCount.X);
+        AddOffsetCS->SetParameter(RHICmdList, FAddOffsetCS::Slot_Params_LevelIndex, Level);
+        AddOffsetCS->DispatchLinear(RHICmdList, DispatchCount, ArgumentBuffer, GetAddOffsetArgsOffset(Level));
+        AddOffsetCS->UnbindBuffers(RHICmdList);
+        RHICmdList.EndComputePass();
     }
 
     return ScanBlockCount;
@@ -0,0 +1,388 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "Shaders/RULRadixSort.h"
+
+#include "ShaderParameters.h"
+#include "ShaderCore.h"
+
+#include "Shaders/RULPrefixSumScan.h"
+#include "Shaders/RULShaderDefinitions.h"
+
+class FRULRadixSortCountCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULRadixSortCountCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULRadixSortCountCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "SrcKeys", SrcKeys
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "HistogramData", HistogramData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_5(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_ElementCount",  Params_ElementCount,
+        "_GroupCount",    Params_GroupCount,
+        "_KeyShift",      Params_KeyShift,
+        "_KeyMask",       Params_KeyMask,
+        "_DispatchWidth", Params_DispatchWidth
+        )
+};
+
+template<uint32 bUseValues>
+class FRULRadixSortScatterCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULRadixSortScatterCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+        OutEnvironment.SetDefine(TEXT("RADIX_SORT_USE_VALUES"), bUseValues);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULRadixSortScatterCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_3(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "SrcKeys",      SrcKeys,
+        "SrcValues",    SrcValues,
+        "DigitOffsets", DigitOffsets
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "DstKeys",   DstKeys,
+        "DstValues", DstValues
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_5(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_ElementCount",  Params_ElementCount,
+        "_GroupCount",    Params_GroupCount,
+        "_KeyShift",      Params_KeyShift,
+        "_KeyMask",       Params_KeyMask,
+        "_DispatchWidth", Params_DispatchWidth
+        )
+};
+
+template<uint32 bUseValues>
+class FRULRadixSortCopyCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULRadixSortCopyCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+        OutEnvironment.SetDefine(TEXT("RADIX_SORT_USE_VALUES"), bUseValues);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULRadixSortCopyCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "SrcKeys",   SrcKeys,
+        "SrcValues", SrcValues
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "DstKeys",   DstKeys,
+        "DstValues", DstValues
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_ElementCount",  Params_ElementCount,
+        "_DispatchWidth", Params_DispatchWidth
+        )
+};
+
+#define SHADER_FILENAME "/Plugin/RenderingUtilityLibrary/Private/RULRadixSortCS.usf"
+
+IMPLEMENT_SHADER_TYPE(, FRULRadixSortCountCS, TEXT(SHADER_FILENAME), TEXT("CountKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FRULRadixSortScatterCS<0>, TEXT(SHADER_FILENAME), TEXT("ScatterKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FRULRadixSortScatterCS<1>, TEXT(SHADER_FILENAME), TEXT("ScatterKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FRULRadixSortCopyCS<0>, TEXT(SHADER_FILENAME), TEXT("CopyKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FRULRadixSortCopyCS<1>, TEXT(SHADER_FILENAME), TEXT("CopyKernel"), SF_Compute);
+
+#undef SHADER_FILENAME
+
+int32 FRULRadixSort::Sort(
+    FRHICommandListImmediate& RHICmdList,
+    FRULRWBufferStructured& KeyBuffer,
+    FRULRWBufferStructured* ValueBuffer,
+    int32 ElementCount,
+    int32 StartBit,
+    int32 EndBit
+    )
+{
+    check(IsInRenderingThread());
+
+    if (ElementCount < 1)
+    {
+        return -1;
+    }
+
+    StartBit = FMath::Clamp(StartBit, 0, 32);
+    EndBit = FMath::Clamp(EndBit, 0, 32);
+
+    if (StartBit >= EndBit)
+    {
+        return 0;
+    }
+
+    // Validate key and value buffers
+
+    if (! KeyBuffer.IsValid() || KeyBuffer.Buffer->GetStride() != sizeof(uint32) || KeyBuffer.GetNumElements() < ElementCount)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULRadixSort::Sort() Key buffer must hold at least %d uint32 elements"), ElementCount);
+        return -1;
+    }
+
+    if (ValueBuffer && (! ValueBuffer->IsValid() || ValueBuffer->Buffer->GetStride() != sizeof(uint32) || ValueBuffer->GetNumElements() < ElementCount))
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULRadixSort::Sort() Value buffer must hold at least %d uint32 elements"), ElementCount);
+        return -1;
+    }
+
+    if (ValueBuffer)
+    {
+        return SortPasses<1>(RHICmdList, KeyBuffer, ValueBuffer, ElementCount, StartBit, EndBit);
+    }
+    else
+    {
+        return SortPasses<0>(RHICmdList, KeyBuffer, nullptr, ElementCount, StartBit, EndBit);
+    }
+}
+
+void FRULRadixSort::Release()
+{
+    ScratchKeys.Release();
+    ScratchValues.Release();
+    HistogramData.Release();
+    OffsetData.Release();
+    SumData.Release();
+}
+
+template<uint32 bUseValues>
+int32 FRULRadixSort::SortPasses(
+    FRHICommandListImmediate& RHICmdList,
+    FRULRWBufferStructured& KeyBuffer,
+    FRULRWBufferStructured* ValueBuffer,
+    int32 ElementCount,
+    int32 StartBit,
+    int32 EndBit
+    )
+{
+    typedef FRULRadixSortCountCS             FCountCS;
+    typedef FRULRadixSortScatterCS<bUseValues> FScatterCS;
+    typedef FRULRadixSortCopyCS<bUseValues>    FCopyCS;
+
+    const int32 GroupCount     = FMath::DivideAndRoundUp(ElementCount, BLOCK_SIZE2);
+    const int32 HistogramCount = GroupCount * RADIX_SIZE;
+    const int32 PassCount      = FMath::DivideAndRoundUp(EndBit-StartBit, RADIX_BITS);
+
+    const FIntPoint DispatchCount = FCountCS::GetLinearDispatchCount(GroupCount);
+
+    // Validate digit histogram scan before recording any pass
+
+    if (FRULPrefixSumScan::GetBlockLevelCount(HistogramCount) < 0)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULRadixSort::Sort() Element count (%d) exceeds the supported histogram scan size"), ElementCount);
+        return -1;
+    }
+
+    // Initialize scratch buffers, reuse existing buffers if the layout matches
+
+    if (! ScratchKeys.HasLayout(sizeof(uint32), ElementCount, BUF_Static))
+    {
+        ScratchKeys.Release();
+        ScratchKeys.Initialize(sizeof(uint32), ElementCount, BUF_Static, TEXT("RULRadixSortScratchKeys"));
+    }
+
+    if (bUseValues && ! ScratchValues.HasLayout(sizeof(uint32), ElementCount, BUF_Static))
+    {
+        ScratchValues.Release();
+        ScratchValues.Initialize(sizeof(uint32), ElementCount, BUF_Static, TEXT("RULRadixSortScratchValues"));
+    }
+
+    if (! HistogramData.HasLayout(sizeof(uint32), HistogramCount, BUF_Static))
+    {
+        HistogramData.Release();
+        HistogramData.Initialize(sizeof(uint32), HistogramCount, BUF_Static, TEXT("RULRadixSortHistogramData"));
+    }
+
+    // Ping-pong between source and scratch buffers, each pass sorts RADIX_BITS key bits
+
+    FRULRWBufferStructured* SrcKeys = &KeyBuffer;
+    FRULRWBufferStructured* DstKeys = &ScratchKeys;
+    FRULRWBufferStructured* SrcValues = bUseValues ? ValueBuffer : nullptr;
+    FRULRWBufferStructured* DstValues = bUseValues ? &ScratchValues : nullptr;
+
+    for (int32 PassIndex=0; PassIndex<PassCount; ++PassIndex)
+    {
+        const int32 KeyShift = StartBit + PassIndex*RADIX_BITS;
+        const int32 KeyBits  = FMath::Min(RADIX_BITS, EndBit-KeyShift);
+        const uint32 KeyMask = (1u << KeyBits) - 1;
+
+        // Digit histogram per group
+
+        RHICmdList.BeginComputePass(TEXT("RULRadixSortCount"));
+        TShaderMapRef<FCountCS> CountCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        CountCS->SetShader(RHICmdList);
+        CountCS->BindSRV(RHICmdList, FCountCS::Slot_SrcKeys, SrcKeys->SRV);
+        CountCS->BindUAV(RHICmdList, FCountCS::Slot_HistogramData, HistogramData.UAV);
+        CountCS->SetParameter(RHICmdList, FCountCS::Slot_Params_ElementCount, ElementCount);
+        CountCS->SetParameter(RHICmdList, FCountCS::Slot_Params_GroupCount, GroupCount);
+        CountCS->SetParameter(RHICmdList, FCountCS::Slot_Params_KeyShift, KeyShift);
+        CountCS->SetParameter(RHICmdList, FCountCS::Slot_Params_KeyMask, KeyMask);
+        CountCS->SetParameter(RHICmdList, FCountCS::Slot_Params_DispatchWidth, DispatchCount.X);
+        DispatchComputeShader(RHICmdList, *CountCS, DispatchCount.X, DispatchCount.Y, 1);
+        CountCS->UnbindBuffers(RHICmdList);
+        RHICmdList.EndComputePass();
+
+        // Global digit offsets
+
+        const int32 ScanResult = FRULPrefixSumScan::ExclusiveScan<FRULPrefixSumScan::SDT_UINT1>(
+            RHICmdList,
+            HistogramData.SRV,
+            sizeof(uint32),
+            HistogramCount,
+            OffsetData,
+            SumData
+            );
+
+        if (ScanResult < 0)
+        {
+            UE_LOG(LogRUL,Error, TEXT("FRULRadixSort::Sort() Digit offset scan failed, sort aborted"));
+            return -1;
+        }
+
+        // Stable scatter
+
+        RHICmdList.BeginComputePass(TEXT("RULRadixSortScatter"));
+        TShaderMapRef<FScatterCS> ScatterCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        ScatterCS->SetShader(RHICmdList);
+        ScatterCS->BindSRV(RHICmdList, FScatterCS::Slot_SrcKeys, SrcKeys->SRV);
+        ScatterCS->BindSRV(RHICmdList, FScatterCS::Slot_DigitOffsets, OffsetData.SRV);
+        ScatterCS->BindUAV(RHICmdList, FScatterCS::Slot_DstKeys, DstKeys->UAV);
+        if (bUseValues)
+        {
+            ScatterCS->BindSRV(RHICmdList, FScatterCS::Slot_SrcValues, SrcValues->SRV);
+            ScatterCS->BindUAV(RHICmdList, FScatterCS::Slot_DstValues, DstValues->UAV);
+        }
+        ScatterCS->SetParameter(RHICmdList, FScatterCS::Slot_Params_ElementCount, ElementCount);
+        ScatterCS->SetParameter(RHICmdList, FScatterCS::Slot_Params_GroupCount, GroupCount);
+        ScatterCS->SetParameter(RHICmdList, FScatterCS::Slot_Params_KeyShift, KeyShift);
+        ScatterCS->SetParameter(RHICmdList, FScatterCS::Slot_Params_KeyMask, KeyMask);
+        ScatterCS->SetParameter(RHICmdList, FScatterCS::Slot_Params_DispatchWidth, DispatchCount.X);
+        DispatchComputeShader(RHICmdList, *ScatterCS, DispatchCount.X, DispatchCount.Y, 1);
+        ScatterCS->UnbindBuffers(RHICmdList);
+        RHICmdList.EndComputePass();
+
+        Swap(SrcKeys, DstKeys);
+        Swap(SrcValues, DstValues);
+    }
+
+    // Copy sorted data back to the source buffers if it ended up in scratch buffers
+
+    if (SrcKeys != &KeyBuffer)
+    {
+        const FIntPoint CopyDispatchCount = FCopyCS::GetLinearDispatchCount(FMath::DivideAndRoundUp(ElementCount, BLOCK_SIZE));
+
+        RHICmdList.BeginComputePass(TEXT("RULRadixSortCopy"));
+        TShaderMapRef<FCopyCS> CopyCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        CopyCS->SetShader(RHICmdList);
+        CopyCS->BindSRV(RHICmdList, FCopyCS::Slot_SrcKeys, SrcKeys->SRV);
+        CopyCS->BindUAV(RHICmdList, FCopyCS::Slot_DstKeys, DstKeys->UAV);
+        if (bUseValues)
+        {
+            CopyCS->BindSRV(RHICmdList, FCopyCS::Slot_SrcValues, SrcValues->SRV);
+            CopyCS->BindUAV(RHICmdList, FCopyCS::Slot_DstValues, DstValues->UAV);
+        }
+        CopyCS->SetParameter(RHICmdList, FCopyCS::Slot_Params_ElementCount, ElementCount);
+        CopyCS->SetParameter(RHICmdList, FCopyCS::Slot_Params_DispatchWidth, CopyDispatchCount.X);
+        DispatchComputeShader(RHICmdList, *CopyCS, CopyDispatchCount.X, CopyDispatchCount.Y, 1);
+        CopyCS->UnbindBuffers(RHICmdList);
+        RHICmdList.EndComputePass();
+    }
+
+    return PassCount;
+}
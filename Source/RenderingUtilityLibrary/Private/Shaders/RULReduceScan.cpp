@@ -32,9 +32,11 @@
 #include "UniformBuffer.h"
 
 #include "RHI/RULAlignedTypes.h"
+#include "RHI/RULRHIBufferPool.h"
+#include "Shaders/RULPrefixSumScan.h"
 #include "Shaders/RULShaderDefinitions.h"
 
-template<uint32 ScanDataType, uint32 ScanOpType>
+template<uint32 ScanDataType, uint32 ScanOpType, uint32 bReducedInput, uint32 bIndirectCount>
 class FRULReduceLocalScanCS : public FRULBaseComputeShader<>
 {
     typedef FRULBaseComputeShader<> FBaseType;
@@ -51,16 +53,21 @@ class FRULReduceLocalScanCS : public FRULBaseComputeShader<>
         FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
         OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
         OutEnvironment.SetDefine(TEXT("data_t"), *FRULReduceScan::GetScanDataTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("accum_t"), *FRULReduceScan::GetScanAccumTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("index_t"), *FRULReduceScan::GetScanIndexTypeName<ScanDataType>());
         OutEnvironment.SetDefine(TEXT("REDUCE_OP"), ScanOpType);
+        OutEnvironment.SetDefine(TEXT("REDUCE_REDUCED_INPUT"), bReducedInput);
+        OutEnvironment.SetDefine(TEXT("SCAN_INDIRECT_COUNT"), bIndirectCount);
     }
 
     RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULReduceLocalScanCS)
 
-    RUL_DECLARE_SHADER_PARAMETERS_1(
+    RUL_DECLARE_SHADER_PARAMETERS_2(
         SRV,
         FShaderResourceParameter,
         FResourceId,
-        "SrcData", SrcData
+        "SrcData",        SrcData,
+        "LevelCountData", LevelCountData
         )
 
     RUL_DECLARE_SHADER_PARAMETERS_1(
@@ -70,11 +77,13 @@ class FRULReduceLocalScanCS : public FRULBaseComputeShader<>
         "SumData", SumData
         )
 
-    RUL_DECLARE_SHADER_PARAMETERS_1(
+    RUL_DECLARE_SHADER_PARAMETERS_3(
         Value,
         FShaderParameter,
         FParameterId,
-        "_ElementCount", Params_ElementCount
+        "_ElementCount",  Params_ElementCount,
+        "_DispatchWidth", Params_DispatchWidth,
+        "_LevelIndex",    Params_LevelIndex
         )
 };
 
@@ -95,6 +104,8 @@ class FRULReduceTextureLocalScanCS : public FRULBaseComputeShader<>
         FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
         OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
         OutEnvironment.SetDefine(TEXT("data_t"), *FRULReduceScan::GetScanDataTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("accum_t"), *FRULReduceScan::GetScanAccumTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("index_t"), *FRULReduceScan::GetScanIndexTypeName<ScanDataType>());
         OutEnvironment.SetDefine(TEXT("REDUCE_OP"), ScanOpType);
     }
 
@@ -118,15 +129,16 @@ class FRULReduceTextureLocalScanCS : public FRULBaseComputeShader<>
         "SumData", SumData
         )
 
-    RUL_DECLARE_SHADER_PARAMETERS_1(
+    RUL_DECLARE_SHADER_PARAMETERS_2(
         Value,
         FShaderParameter,
         FParameterId,
-        "_Dimension", Params_Dimension
+        "_Dimension",     Params_Dimension,
+        "_DispatchWidth", Params_DispatchWidth
         )
 };
 
-template<uint32 ScanDataType, uint32 ScanOpType>
+template<uint32 ScanDataType, uint32 ScanOpType, uint32 bIndirectCount>
 class FRULReduceTopLevelScanCS : public FRULBaseComputeShader<>
 {
     typedef FRULBaseComputeShader<> FBaseType;
@@ -143,12 +155,20 @@ class FRULReduceTopLevelScanCS : public FRULBaseComputeShader<>
         FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
         OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
         OutEnvironment.SetDefine(TEXT("data_t"), *FRULReduceScan::GetScanDataTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("accum_t"), *FRULReduceScan::GetScanAccumTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("index_t"), *FRULReduceScan::GetScanIndexTypeName<ScanDataType>());
         OutEnvironment.SetDefine(TEXT("REDUCE_OP"), ScanOpType);
+        OutEnvironment.SetDefine(TEXT("SCAN_INDIRECT_COUNT"), bIndirectCount);
     }
 
     RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULReduceTopLevelScanCS)
 
-    RUL_DECLARE_SHADER_PARAMETERS_0(SRV,,)
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "LevelCountData", LevelCountData
+        )
 
     RUL_DECLARE_SHADER_PARAMETERS_1(
         UAV,
@@ -157,17 +177,18 @@ class FRULReduceTopLevelScanCS : public FRULBaseComputeShader<>
         "SumData", SumData
         )
 
-    RUL_DECLARE_SHADER_PARAMETERS_3(
+    RUL_DECLARE_SHADER_PARAMETERS_4(
         Value,
         FShaderParameter,
         FParameterId,
         "_ElementCount",   Params_ElementCount,
         "_BlockCount",     Params_BlockCount,
-        "_ScanBlockCount", Params_ScanBlockCount
+        "_ScanBlockCount", Params_ScanBlockCount,
+        "_LevelIndex",     Params_LevelIndex
         )
 };
 
-template<uint32 ScanDataType>
+template<uint32 ScanDataType, uint32 ScanOpType>
 class FRULWriteScanResultCS : public FRULBaseComputeShader<>
 {
     typedef FRULBaseComputeShader<> FBaseType;
@@ -184,6 +205,10 @@ class FRULWriteScanResultCS : public FRULBaseComputeShader<>
         FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
         OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
         OutEnvironment.SetDefine(TEXT("data_t"), *FRULReduceScan::GetScanDataTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("accum_t"), *FRULReduceScan::GetScanAccumTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("index_t"), *FRULReduceScan::GetScanIndexTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("REDUCE_OP"), ScanOpType);
+        OutEnvironment.SetDefine(TEXT("REDUCE_REDUCED_INPUT"), 1);
     }
 
     RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULWriteScanResultCS)
@@ -199,30 +224,183 @@ class FRULWriteScanResultCS : public FRULBaseComputeShader<>
         UAV,
         FShaderResourceParameter,
         FResourceId,
-        "SumData", SumData
+        "ResultData", ResultData
         )
 
-    RUL_DECLARE_SHADER_PARAMETERS_2(
+    RUL_DECLARE_SHADER_PARAMETERS_3(
         Value,
         FShaderParameter,
         FParameterId,
+        "_Dimension", Params_Dimension,
         "_ElementCount", Params_ElementCount,
         "_ResultIndex", Params_ResultIndex
         )
 };
 
+template<uint32 ScanDataType, uint32 ScanOpType, uint32 bUseTexture>
+class FRULReduceSinglePassCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULReduceSinglePassCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform) && FRULReduceScan::IsSinglePassSupported(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+        OutEnvironment.SetDefine(TEXT("data_t"), *FRULReduceScan::GetScanDataTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("accum_t"), *FRULReduceScan::GetScanAccumTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("index_t"), *FRULReduceScan::GetScanIndexTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("REDUCE_OP"), ScanOpType);
+        OutEnvironment.SetDefine(TEXT("SINGLE_PASS_USE_TEXTURE"), bUseTexture);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER_WITH_TEXTURE(FRULReduceSinglePassCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        Texture,
+        FShaderResourceParameter,
+        FResourceId,
+        "SourceTexture", SourceTexture
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_0(Sampler,,)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "SrcData", SrcData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_3(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "ResultData",  ResultData,
+        "PartialData", PartialData,
+        "CounterData", CounterData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_4(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_Dimension",    Params_Dimension,
+        "_ElementCount", Params_ElementCount,
+        "_ResultIndex",  Params_ResultIndex,
+        "_GroupCount",   Params_GroupCount
+        )
+};
+
+template<uint32 ScanDataType, uint32 ScanOpType>
+class FRULReduceSegmentedCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULReduceSegmentedCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+        OutEnvironment.SetDefine(TEXT("data_t"), *FRULReduceScan::GetScanDataTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("accum_t"), *FRULReduceScan::GetScanAccumTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("index_t"), *FRULReduceScan::GetScanIndexTypeName<ScanDataType>());
+        OutEnvironment.SetDefine(TEXT("REDUCE_OP"), ScanOpType);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULReduceSegmentedCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "SrcData",        SrcData,
+        "SegmentOffsets", SegmentOffsets
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "ResultData", ResultData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_4(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_Dimension",    Params_Dimension,
+        "_ElementCount", Params_ElementCount,
+        "_SegmentCount", Params_SegmentCount,
+        "_GroupCount",   Params_GroupCount
+        )
+};
+
+// Single pass reduction group counter, reset to zero by the last group of each dispatch
+
+class FRULReduceCounterBuffer : public FRenderResource
+{
+public:
+
+    FRULRWBufferStructured CounterData;
+
+    virtual void InitDynamicRHI() override
+    {
+        if (FRULReduceScan::IsSinglePassSupported(GMaxRHIShaderPlatform))
+        {
+            TResourceArray<uint32, VERTEXBUFFER_ALIGNMENT> DefaultCounterData(false);
+            DefaultCounterData.SetNumZeroed(1);
+            CounterData.Initialize(sizeof(uint32), 1, &DefaultCounterData, BUF_Static, TEXT("RULReduceCounterData"));
+        }
+    }
+
+    virtual void ReleaseDynamicRHI() override
+    {
+        CounterData.Release();
+    }
+};
+
+static TGlobalResource<FRULReduceCounterBuffer> GRULReduceCounterBuffer;
+
 #define SHADER_FILENAME "/Plugin/RenderingUtilityLibrary/Private/RULReduceScanCS.usf"
-#define SCAN_KERNEL1(N,VN)   N<VN>
 #define SCAN_KERNEL2(N,VN,T) N<VN,T>
+#define SCAN_KERNEL3(N,VN,T,U) N<VN,T,U>
+#define SCAN_KERNEL4(N,VN,T,U,V) N<VN,T,U,V>
+
+#define IMPLEMENT_SCAN_OP_SHADER(VN,OP) \
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL4(FRULReduceLocalScanCS,VN,OP,0,0), TEXT(SHADER_FILENAME), TEXT("LocalScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL4(FRULReduceLocalScanCS,VN,OP,1,0), TEXT(SHADER_FILENAME), TEXT("LocalScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL4(FRULReduceLocalScanCS,VN,OP,0,1), TEXT(SHADER_FILENAME), TEXT("LocalScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL4(FRULReduceLocalScanCS,VN,OP,1,1), TEXT(SHADER_FILENAME), TEXT("LocalScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULReduceTextureLocalScanCS,VN,OP), TEXT(SHADER_FILENAME), TEXT("TextureLocalScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL3(FRULReduceTopLevelScanCS,VN,OP,0), TEXT(SHADER_FILENAME), TEXT("TopLevelScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL3(FRULReduceTopLevelScanCS,VN,OP,1), TEXT(SHADER_FILENAME), TEXT("TopLevelScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULWriteScanResultCS,VN,OP), TEXT(SHADER_FILENAME), TEXT("WriteScanResultKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL3(FRULReduceSinglePassCS,VN,OP,0), TEXT(SHADER_FILENAME), TEXT("SinglePassReduceKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL3(FRULReduceSinglePassCS,VN,OP,1), TEXT(SHADER_FILENAME), TEXT("SinglePassReduceKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULReduceSegmentedCS,VN,OP), TEXT(SHADER_FILENAME), TEXT("SegmentedReduceKernel"), SF_Compute);
 
 #define IMPLEMENT_SCAN_SHADER(VN) \
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULReduceLocalScanCS,VN,0), TEXT(SHADER_FILENAME), TEXT("LocalScanKernel"), SF_Compute);\
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULReduceLocalScanCS,VN,1), TEXT(SHADER_FILENAME), TEXT("LocalScanKernel"), SF_Compute);\
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULReduceTextureLocalScanCS,VN,0), TEXT(SHADER_FILENAME), TEXT("TextureLocalScanKernel"), SF_Compute);\
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULReduceTextureLocalScanCS,VN,1), TEXT(SHADER_FILENAME), TEXT("TextureLocalScanKernel"), SF_Compute);\
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULReduceTopLevelScanCS,VN,0), TEXT(SHADER_FILENAME), TEXT("TopLevelScanKernel"), SF_Compute);\
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL2(FRULReduceTopLevelScanCS,VN,1), TEXT(SHADER_FILENAME), TEXT("TopLevelScanKernel"), SF_Compute);\
-IMPLEMENT_SHADER_TYPE(template<>, SCAN_KERNEL1(FRULWriteScanResultCS,VN), TEXT(SHADER_FILENAME), TEXT("WriteScanResultKernel"), SF_Compute);\
+IMPLEMENT_SCAN_OP_SHADER(VN, FRULReduceScan::SOT_Max)\
+IMPLEMENT_SCAN_OP_SHADER(VN, FRULReduceScan::SOT_Min)\
+IMPLEMENT_SCAN_OP_SHADER(VN, FRULReduceScan::SOT_MinMax)\
+IMPLEMENT_SCAN_OP_SHADER(VN, FRULReduceScan::SOT_Sum)\
+IMPLEMENT_SCAN_OP_SHADER(VN, FRULReduceScan::SOT_SumCompensated)\
+IMPLEMENT_SCAN_OP_SHADER(VN, FRULReduceScan::SOT_MeanVariance)\
+IMPLEMENT_SCAN_OP_SHADER(VN, FRULReduceScan::SOT_ArgMin)\
+IMPLEMENT_SCAN_OP_SHADER(VN, FRULReduceScan::SOT_ArgMax)
 
 IMPLEMENT_SCAN_SHADER(FRULReduceScan::SDT_UINT1)
 IMPLEMENT_SCAN_SHADER(FRULReduceScan::SDT_UINT2)
@@ -232,12 +410,14 @@ IMPLEMENT_SCAN_SHADER(FRULReduceScan::SDT_FLOAT1)
 IMPLEMENT_SCAN_SHADER(FRULReduceScan::SDT_FLOAT2)
 IMPLEMENT_SCAN_SHADER(FRULReduceScan::SDT_FLOAT4)
 
+#undef IMPLEMENT_SCAN_OP_SHADER
 #undef IMPLEMENT_SCAN_SHADER
-#undef SCAN_KERNEL1
 #undef SCAN_KERNEL2
+#undef SCAN_KERNEL3
+#undef SCAN_KERNEL4
 #undef SHADER_FILENAME
 
-template<uint32 ScanDataType, uint32 ScanOpType>
+template<uint32 ScanDataType, uint32 ScanOpType, uint32 ReduceMethod>
 int32 FRULReduceScan::Reduce(
     FRHICommandListImmediate& RHICmdList,
     FShaderResourceViewRHIParamRef SrcDataSRV,
@@ -258,124 +438,217 @@ int32 FRULReduceScan::Reduce(
 
     check(DataStride > 0);
 
-    int32 BlockCount      = FMath::DivideAndRoundUp(ElementCount, BLOCK_SIZE2);
-    int32 BlockGroupCount = FMath::DivideAndRoundUp(BlockCount, BLOCK_SIZE2);
+    if (DataStride != GetScanDataTypeStride<ScanDataType>())
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULReduceScan::Reduce() Data stride (%d) does not match scan data type stride (%d)"),
+            DataStride,
+            GetScanDataTypeStride<ScanDataType>());
+        return -1;
+    }
+
+    // Fused and statistic reductions carry multiple values per element
+    // through every intermediate pass
+
+    const int32 OutputCount   = GetScanOpOutputCount<ScanOpType>();
+    const int32 ReducedStride = DataStride * GetScanOpReducedValueCount<ScanOpType>();
 
-    int32 ScanBlockCount      = FPlatformMath::RoundUpToPowerOfTwo(BlockCount);
-    int32 ScanBlockGroupCount = FPlatformMath::RoundUpToPowerOfTwo(BlockGroupCount);
+    const int32 BlockLevelCount = GetBlockLevelCount(ElementCount);
 
+    if (BlockLevelCount < 0)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULReduceScan::Reduce() Element count (%d) exceeds the supported scan hierarchy"), ElementCount);
+        return -1;
+    }
+
+    int32 BlockCount     = FMath::DivideAndRoundUp(ElementCount, BLOCK_SIZE2);
+    int32 ScanBlockCount = FPlatformMath::RoundUpToPowerOfTwo(BlockCount);
     int32 SumBufferCount = ScanBlockCount + 1;
 
     check(BlockCount > 0);
 
     UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() ElementCount: %d"), ElementCount);
     UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() BlockCount: %d"), BlockCount);
-    UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() BlockGroupCount: %d"), BlockGroupCount);
+    UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() BlockLevelCount: %d"), BlockLevelCount);
     UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() ScanBlockCount: %d"), ScanBlockCount);
-    UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() ScanBlockGroupCount: %d"), ScanBlockGroupCount);
     UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() SumBufferCount: %d"), SumBufferCount);
     UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() BLOCK_SIZE2: %d"), BLOCK_SIZE2);
 
-    // Reset result buffer
+    // Reset result buffer if it does not match the required layout
 
-    ResultBuffer.Release();
-    ResultBuffer.Initialize(DataStride, 1, AdditionalOutputUsage);
+    if (! ResultBuffer.HasLayout(DataStride, OutputCount, AdditionalOutputUsage))
+    {
+        ResultBuffer.Release();
+        ResultBuffer.Initialize(DataStride, OutputCount, AdditionalOutputUsage);
+    }
 
-    // Initialize sum buffer
+    // Single pass reduction
 
-    FRULRWBufferStructured SumBuffer;
+    if (ReduceMethod == RM_SinglePass && IsSinglePassSupported(GMaxRHIShaderPlatform))
     {
-        TResourceArray<uint8, VERTEXBUFFER_ALIGNMENT> DefaultSumData(false);
-        DefaultSumData.SetNumZeroed(DataStride * SumBufferCount);
-        SumBuffer.Initialize(DataStride, SumBufferCount, &DefaultSumData, AdditionalOutputUsage);
+        return ReduceSinglePass<ScanDataType, ScanOpType, 0>(
+            RHICmdList,
+            SrcDataSRV,
+            nullptr,
+            ResultBuffer,
+            FIntPoint(ElementCount, 1),
+            DataStride,
+            ElementCount,
+            0,
+            AdditionalOutputUsage
+            );
     }
 
+    // Acquire sum buffer. Kernels only read entries written by earlier
+    // dispatches so scratch buffer contents do not need to be cleared.
+
+    FRULPooledRWBufferStructured SumBuffer;
+    SumBuffer.Acquire(ReducedStride, SumBufferCount, AdditionalOutputUsage);
+
+    typedef FRULReduceLocalScanCS<ScanDataType, ScanOpType, 0, 0> FLocalScanCS;
+
+    const FIntPoint DispatchCount = FLocalScanCS::GetLinearDispatchCount(BlockCount);
+
     // Local scan kernel
 
     RHICmdList.BeginComputePass(TEXT("RULReduceLocalScan"));
-    TShaderMapRef<FRULReduceLocalScanCS<ScanDataType, ScanOpType>> LocalScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+    TShaderMapRef<FLocalScanCS> LocalScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
     LocalScanCS->SetShader(RHICmdList);
-    LocalScanCS->BindSRV(RHICmdList, TEXT("SrcData"), SrcDataSRV);
-    LocalScanCS->BindUAV(RHICmdList, TEXT("SumData"), SumBuffer.UAV);
-    LocalScanCS->SetParameter(RHICmdList, TEXT("_ElementCount"), ElementCount);
-    DispatchComputeShader(RHICmdList, *LocalScanCS, BlockCount, 1, 1);
+    LocalScanCS->BindSRV(RHICmdList, FLocalScanCS::Slot_SrcData, SrcDataSRV);
+    LocalScanCS->BindUAV(RHICmdList, FLocalScanCS::Slot_SumData, SumBuffer.UAV);
+    LocalScanCS->SetParameter(RHICmdList, FLocalScanCS::Slot_Params_ElementCount, ElementCount);
+    LocalScanCS->SetParameter(RHICmdList, FLocalScanCS::Slot_Params_DispatchWidth, DispatchCount.X);
+    DispatchComputeShader(RHICmdList, *LocalScanCS, DispatchCount.X, DispatchCount.Y, 1);
     LocalScanCS->UnbindBuffers(RHICmdList);
     RHICmdList.EndComputePass();
 
-    if (BlockGroupCount > 1)
-    {
-        int32 SumBlockBufferCount = ScanBlockGroupCount+1;
+    // Reduce block sums and write result
 
-        FRULRWBufferStructured SumBlockBuffer;
-        SumBlockBuffer.Initialize(DataStride, SumBlockBufferCount, BUF_Static);
+    ReduceBlockLevels<ScanDataType, ScanOpType, 0>(
+        RHICmdList,
+        SumBuffer,
+        BlockCount,
+        ResultBuffer,
+        FIntVector4(ElementCount, 1, 0, 0),
+        0,
+        ReducedStride
+        );
 
-        // Block sum scan
+    return ScanBlockCount;
+}
 
-        RHICmdList.BeginComputePass(TEXT("RULReduceLocalScan"));
-        TShaderMapRef<FRULReduceLocalScanCS<ScanDataType, ScanOpType>> BlockScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-        BlockScanCS->SetShader(RHICmdList);
-        BlockScanCS->BindSRV(RHICmdList, TEXT("SrcData"), SumBuffer.SRV);
-        BlockScanCS->BindUAV(RHICmdList, TEXT("SumData"), SumBlockBuffer.UAV);
-        BlockScanCS->SetParameter(RHICmdList, TEXT("_ElementCount"), ElementCount);
-        DispatchComputeShader(RHICmdList, *BlockScanCS, BlockGroupCount, 1, 1);
-        BlockScanCS->UnbindBuffers(RHICmdList);
-        RHICmdList.EndComputePass();
+template<uint32 ScanDataType, uint32 ScanOpType>
+int32 FRULReduceScan::Reduce(
+    FRHICommandListImmediate& RHICmdList,
+    FShaderResourceViewRHIParamRef SrcDataSRV,
+    FRULRWBufferStructured& ResultBuffer,
+    int32 DataStride,
+    int32 MaxElementCount,
+    FShaderResourceViewRHIParamRef ElementCountSRV,
+    int32 ElementCountIndex,
+    FRULRWBuffer& DispatchArgsBuffer,
+    uint32 AdditionalOutputUsage
+    )
+{
+    check(IsInRenderingThread());
+    check(IsValidScanDataType<ScanDataType>());
+    check(IsValidScanOpType<ScanOpType>());
 
-        // Block sum top level scan
+    if (MaxElementCount < 1)
+    {
+        return -1;
+    }
 
-        RHICmdList.BeginComputePass(TEXT("RULReduceTopLevelScan"));
-        TShaderMapRef<FRULReduceTopLevelScanCS<ScanDataType, ScanOpType>> TopLevelScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-        TopLevelScanCS->SetShader(RHICmdList);
-        TopLevelScanCS->BindUAV(RHICmdList, TEXT("SumData"), SumBlockBuffer.UAV);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_BlockCount"), BlockGroupCount);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_ScanBlockCount"), ScanBlockGroupCount);
-        DispatchComputeShader(RHICmdList, *TopLevelScanCS, 1, 1, 1);
-        TopLevelScanCS->UnbindBuffers(RHICmdList);
-        RHICmdList.EndComputePass();
+    check(DataStride > 0);
 
-        // Write result
+    if (DataStride != GetScanDataTypeStride<ScanDataType>())
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULReduceScan::Reduce() Data stride (%d) does not match scan data type stride (%d)"),
+            DataStride,
+            GetScanDataTypeStride<ScanDataType>());
+        return -1;
+    }
 
-        RHICmdList.BeginComputePass(TEXT("RULWriteScanResult"));
-        TShaderMapRef<FRULWriteScanResultCS<ScanDataType>> WriteResultCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-        WriteResultCS->SetShader(RHICmdList);
-        WriteResultCS->BindSRV(RHICmdList, TEXT("SrcData"), SumBlockBuffer.SRV);
-        WriteResultCS->BindUAV(RHICmdList, TEXT("SumData"), ResultBuffer.UAV);
-        WriteResultCS->SetParameter(RHICmdList, TEXT("_ElementCount"), SumBlockBufferCount);
-        DispatchComputeShader(RHICmdList, *WriteResultCS, 1, 1, 1);
-        WriteResultCS->UnbindBuffers(RHICmdList);
-        RHICmdList.EndComputePass();
+    if (! ElementCountSRV || ElementCountIndex < 0)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULReduceScan::Reduce() Invalid element count buffer"));
+        return -1;
     }
-    else
+
+    const int32 OutputCount   = GetScanOpOutputCount<ScanOpType>();
+    const int32 ReducedStride = DataStride * GetScanOpReducedValueCount<ScanOpType>();
+
+    if (GetBlockLevelCount(MaxElementCount) < 0)
     {
-        // Top level scan
+        UE_LOG(LogRUL,Error, TEXT("FRULReduceScan::Reduce() Element count (%d) exceeds the supported scan hierarchy"), MaxElementCount);
+        return -1;
+    }
 
-        RHICmdList.BeginComputePass(TEXT("RULReduceTopLevelScan"));
-        TShaderMapRef<FRULReduceTopLevelScanCS<ScanDataType, ScanOpType>> TopLevelScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-        TopLevelScanCS->SetShader(RHICmdList);
-        TopLevelScanCS->BindUAV(RHICmdList, TEXT("SumData"), SumBuffer.UAV);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_BlockCount"), BlockCount);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_ScanBlockCount"), ScanBlockCount);
-        DispatchComputeShader(RHICmdList, *TopLevelScanCS, 1, 1, 1);
-        TopLevelScanCS->UnbindBuffers(RHICmdList);
-        RHICmdList.EndComputePass();
+    int32 BlockCount     = FMath::DivideAndRoundUp(MaxElementCount, BLOCK_SIZE2);
+    int32 ScanBlockCount = FPlatformMath::RoundUpToPowerOfTwo(BlockCount);
+    int32 SumBufferCount = ScanBlockCount + 1;
 
-        // Write result
+    // Reset result buffer if it does not match the required layout
 
-        RHICmdList.BeginComputePass(TEXT("RULWriteScanResult"));
-        TShaderMapRef<FRULWriteScanResultCS<ScanDataType>> WriteResultCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-        WriteResultCS->SetShader(RHICmdList);
-        WriteResultCS->BindSRV(RHICmdList, TEXT("SrcData"), SumBuffer.SRV);
-        WriteResultCS->BindUAV(RHICmdList, TEXT("SumData"), ResultBuffer.UAV);
-        WriteResultCS->SetParameter(RHICmdList, TEXT("_ElementCount"), SumBufferCount);
-        DispatchComputeShader(RHICmdList, *WriteResultCS, 1, 1, 1);
-        WriteResultCS->UnbindBuffers(RHICmdList);
-        RHICmdList.EndComputePass();
+    if (! ResultBuffer.HasLayout(DataStride, OutputCount, AdditionalOutputUsage))
+    {
+        ResultBuffer.Release();
+        ResultBuffer.Initialize(DataStride, OutputCount, AdditionalOutputUsage);
     }
 
+    // Level element counts and dispatch arguments of the GPU element count
+
+    FRULPooledRWBufferStructured LevelCountData;
+    LevelCountData.Acquire(sizeof(uint32), MAX_BLOCK_LEVELS+1, BUF_Static);
+
+    FRULPrefixSumScan::WriteLevelDispatchArgs(
+        RHICmdList,
+        ElementCountSRV,
+        ElementCountIndex,
+        MaxElementCount,
+        LevelCountData,
+        DispatchArgsBuffer
+        );
+
+    FRULPooledRWBufferStructured SumBuffer;
+    SumBuffer.Acquire(ReducedStride, SumBufferCount, AdditionalOutputUsage);
+
+    typedef FRULReduceLocalScanCS<ScanDataType, ScanOpType, 0, 1> FLocalScanCS;
+
+    const FIntPoint DispatchCount = FLocalScanCS::GetLinearDispatchCount(BlockCount);
+
+    // Local scan kernel
+
+    RHICmdList.BeginComputePass(TEXT("RULReduceLocalScan"));
+    TShaderMapRef<FLocalScanCS> LocalScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+    LocalScanCS->SetShader(RHICmdList);
+    LocalScanCS->BindSRV(RHICmdList, FLocalScanCS::Slot_SrcData, SrcDataSRV);
+    LocalScanCS->BindSRV(RHICmdList, FLocalScanCS::Slot_LevelCountData, LevelCountData.SRV);
+    LocalScanCS->BindUAV(RHICmdList, FLocalScanCS::Slot_SumData, SumBuffer.UAV);
+    LocalScanCS->SetParameter(RHICmdList, FLocalScanCS::Slot_Params_ElementCount, MaxElementCount);
+    LocalScanCS->SetParameter(RHICmdList, FLocalScanCS::Slot_Params_DispatchWidth, DispatchCount.X);
+    LocalScanCS->SetParameter(RHICmdList, FLocalScanCS::Slot_Params_LevelIndex, 0);
+    LocalScanCS->DispatchLinear(RHICmdList, DispatchCount, DispatchArgsBuffer.Buffer, FRULPrefixSumScan::GetScanArgsOffset(0));
+    LocalScanCS->UnbindBuffers(RHICmdList);
+    RHICmdList.EndComputePass();
+
+    // Reduce block sums and write result
+
+    ReduceBlockLevels<ScanDataType, ScanOpType, 1>(
+        RHICmdList,
+        SumBuffer,
+        BlockCount,
+        ResultBuffer,
+        FIntVector4(MaxElementCount, 1, 0, 0),
+        0,
+        ReducedStride,
+        LevelCountData.SRV,
+        DispatchArgsBuffer.Buffer
+        );
+
     return ScanBlockCount;
 }
 
-template<uint32 ScanOpType>
+template<uint32 ScanOpType, uint32 ReduceMethod>
 int32 FRULReduceScan::ReduceTexture(
     FRHICommandListImmediate& RHICmdList,
     FTextureRHIParamRef SourceTexture,
@@ -393,6 +666,9 @@ int32 FRULReduceScan::ReduceTexture(
     enum { ScanDataType = FRULReduceScan::SDT_FLOAT4 };
     enum { DataStride = sizeof(FVector4) };
 
+    const int32 OutputCount   = GetScanOpOutputCount<ScanOpType>();
+    const int32 ReducedStride = DataStride * GetScanOpReducedValueCount<ScanOpType>();
+
     if (! SourceTexture || ElementCount < 1)
     {
         return -1;
@@ -403,28 +679,54 @@ int32 FRULReduceScan::ReduceTexture(
     // Initialize result buffer if required
     if (bInitializeResultBuffer)
     {
-        ResultBuffer.Release();
-        ResultBuffer.Initialize(DataStride, ResultIndex+1, AdditionalOutputUsage);
+        if (! ResultBuffer.HasLayout(DataStride, ResultIndex+OutputCount, AdditionalOutputUsage))
+        {
+            ResultBuffer.Release();
+            ResultBuffer.Initialize(DataStride, ResultIndex+OutputCount, AdditionalOutputUsage);
+        }
     }
     // Otherwise make sure result buffer is valid
     else
-    if (! ResultBuffer.IsValidIndex(ResultIndex))
+    if (! ResultBuffer.IsValidIndex(ResultIndex+OutputCount-1))
     {
         return -1;
     }
 
     check(IsValidScanDataType<ScanDataType>());
 
-    int32 TexDispatchX = FMath::DivideAndRoundUp(Dimension.X, TEX_BLOCK2);
-    int32 TexDispatchY = FMath::DivideAndRoundUp(Dimension.Y, TEX_BLOCK2);
+    // Single pass reduction
+
+    if (ReduceMethod == RM_SinglePass && IsSinglePassSupported(GMaxRHIShaderPlatform))
+    {
+        return ReduceSinglePass<ScanDataType, ScanOpType, 1>(
+            RHICmdList,
+            nullptr,
+            SourceTexture,
+            ResultBuffer,
+            Dimension,
+            DataStride,
+            ElementCount,
+            ResultIndex,
+            AdditionalOutputUsage
+            );
+    }
+
+    // Texture local scan threads load two horizontally adjacent texels,
+    // block count is computed from the padded row extent
+
     int32 TexExtentX = FMath::DivideAndRoundUp(Dimension.X, 2);
+    int32 TexElementCount = TexExtentX * 2 * Dimension.Y;
 
-    int32 BlockCount      = FMath::DivideAndRoundUp(ElementCount, BLOCK_SIZE2);
-    int32 BlockGroupCount = FMath::DivideAndRoundUp(BlockCount, BLOCK_SIZE2);
+    const int32 BlockLevelCount = GetBlockLevelCount(TexElementCount);
 
-    int32 ScanBlockCount      = FPlatformMath::RoundUpToPowerOfTwo(BlockCount);
-    int32 ScanBlockGroupCount = FPlatformMath::RoundUpToPowerOfTwo(BlockGroupCount);
+    if (BlockLevelCount < 0)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULReduceScan::ReduceTexture() Texture dimension (%s) exceeds the supported scan hierarchy"), *Dimension.ToString());
+        return -1;
+    }
 
+    int32 BlockCount     = FMath::DivideAndRoundUp(TexElementCount, BLOCK_SIZE2);
+    int32 ScanBlockCount = FPlatformMath::RoundUpToPowerOfTwo(BlockCount);
     int32 SumBufferCount = ScanBlockCount + 1;
 
     FIntVector4 DimensionData(Dimension.X, Dimension.Y, TexExtentX, 0);
@@ -433,104 +735,248 @@ int32 FRULReduceScan::ReduceTexture(
 
     UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() ElementCount: %d"), ElementCount);
     UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() BlockCount: %d"), BlockCount);
-    UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() BlockGroupCount: %d"), BlockGroupCount);
+    UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() BlockLevelCount: %d"), BlockLevelCount);
     UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() ScanBlockCount: %d"), ScanBlockCount);
-    UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() ScanBlockGroupCount: %d"), ScanBlockGroupCount);
     UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() SumBufferCount: %d"), SumBufferCount);
     UE_LOG(UntRUL,Warning, TEXT("RULReduceScan::Reduce() BLOCK_SIZE2: %d"), BLOCK_SIZE2);
 
-    // Initialize sum buffer
+    // Acquire sum buffer
 
-    FRULRWBufferStructured SumBuffer;
-    {
-        TResourceArray<uint8, VERTEXBUFFER_ALIGNMENT> DefaultSumData(false);
-        DefaultSumData.SetNumZeroed(DataStride * SumBufferCount);
-        SumBuffer.Initialize(DataStride, SumBufferCount, &DefaultSumData, AdditionalOutputUsage);
-    }
+    FRULPooledRWBufferStructured SumBuffer;
+    SumBuffer.Acquire(ReducedStride, SumBufferCount, AdditionalOutputUsage);
+
+    typedef FRULReduceTextureLocalScanCS<ScanDataType, ScanOpType> FTextureLocalScanCS;
+
+    const FIntPoint DispatchCount = FTextureLocalScanCS::GetLinearDispatchCount(BlockCount);
 
     // Local scan kernel
 
     RHICmdList.BeginComputePass(TEXT("RULReduceTextureLocalScan"));
-    TShaderMapRef<FRULReduceTextureLocalScanCS<ScanDataType, ScanOpType>> LocalScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+    TShaderMapRef<FTextureLocalScanCS> LocalScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
     LocalScanCS->SetShader(RHICmdList);
-    LocalScanCS->BindTexture(RHICmdList, TEXT("SourceTexture"), SourceTexture);
-    LocalScanCS->BindUAV(RHICmdList, TEXT("SumData"), SumBuffer.UAV);
-    LocalScanCS->SetParameter(RHICmdList, TEXT("_Dimension"), DimensionData);
-    DispatchComputeShader(RHICmdList, *LocalScanCS, BlockCount, 1, 1);
+    LocalScanCS->BindTexture(RHICmdList, FTextureLocalScanCS::Slot_SourceTexture, SourceTexture);
+    LocalScanCS->BindUAV(RHICmdList, FTextureLocalScanCS::Slot_SumData, SumBuffer.UAV);
+    LocalScanCS->SetParameter(RHICmdList, FTextureLocalScanCS::Slot_Params_Dimension, DimensionData);
+    LocalScanCS->SetParameter(RHICmdList, FTextureLocalScanCS::Slot_Params_DispatchWidth, DispatchCount.X);
+    DispatchComputeShader(RHICmdList, *LocalScanCS, DispatchCount.X, DispatchCount.Y, 1);
     LocalScanCS->UnbindBuffers(RHICmdList);
     RHICmdList.EndComputePass();
 
-    if (BlockGroupCount > 1)
+    // Reduce block sums and write result
+
+    ReduceBlockLevels<ScanDataType, ScanOpType, 0>(
+        RHICmdList,
+        SumBuffer,
+        BlockCount,
+        ResultBuffer,
+        DimensionData,
+        ResultIndex,
+        ReducedStride
+        );
+
+    return ScanBlockCount;
+}
+
+template<uint32 ScanDataType, uint32 ScanOpType, uint32 bIndirectCount>
+void FRULReduceScan::ReduceBlockLevels(
+    FRHICommandListImmediate& RHICmdList,
+    FRULRWBufferStructured& SumBuffer,
+    int32 BlockCount,
+    FRULRWBufferStructured& ResultBuffer,
+    const FIntVector4& DimensionData,
+    int32 ResultIndex,
+    int32 ReducedStride,
+    FShaderResourceViewRHIParamRef LevelCountSRV,
+    FVertexBufferRHIParamRef ArgumentBuffer
+    )
+{
+    check(IsInRenderingThread());
+    check(BlockCount > 0);
+
+    typedef FRULReduceLocalScanCS<ScanDataType, ScanOpType, 1, bIndirectCount> FBlockScanCS;
+    typedef FRULReduceTopLevelScanCS<ScanDataType, ScanOpType, bIndirectCount> FTopLevelScanCS;
+    typedef FRULWriteScanResultCS<ScanDataType, ScanOpType>                    FWriteResultCS;
+
+    // Block scan each level until the block sums fit within a single top level scan group
+
+    FRULPooledRWBufferStructured LevelBuffers[MAX_BLOCK_LEVELS];
+
+    FRULRWBufferStructured* LevelBuffer = &SumBuffer;
+    int32 LevelCount = BlockCount;
+    int32 LevelIndex = 0;
+
+    while (LevelCount > BLOCK_SIZE2)
     {
-        int32 SumBlockBufferCount = ScanBlockGroupCount+1;
+        check(LevelIndex < MAX_BLOCK_LEVELS);
 
-        FRULRWBufferStructured SumBlockBuffer;
-        SumBlockBuffer.Initialize(DataStride, SumBlockBufferCount, BUF_Static);
+        const int32 NextLevelCount = FMath::DivideAndRoundUp(LevelCount, BLOCK_SIZE2);
+        const FIntPoint DispatchCount = FBlockScanCS::GetLinearDispatchCount(NextLevelCount);
 
-        // Block sum scan
+        FRULPooledRWBufferStructured& NextLevelBuffer(LevelBuffers[LevelIndex]);
+        NextLevelBuffer.Acquire(ReducedStride, FPlatformMath::RoundUpToPowerOfTwo(NextLevelCount)+1, BUF_Static);
 
         RHICmdList.BeginComputePass(TEXT("RULReduceLocalScan"));
-        TShaderMapRef<FRULReduceLocalScanCS<ScanDataType, ScanOpType>> BlockScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        TShaderMapRef<FBlockScanCS> BlockScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
         BlockScanCS->SetShader(RHICmdList);
-        BlockScanCS->BindSRV(RHICmdList, TEXT("SrcData"), SumBuffer.SRV);
-        BlockScanCS->BindUAV(RHICmdList, TEXT("SumData"), SumBlockBuffer.UAV);
-        BlockScanCS->SetParameter(RHICmdList, TEXT("_ElementCount"), ElementCount);
-        DispatchComputeShader(RHICmdList, *BlockScanCS, BlockGroupCount, 1, 1);
+        BlockScanCS->BindSRV(RHICmdList, FBlockScanCS::Slot_SrcData, LevelBuffer->SRV);
+        BlockScanCS->BindSRV(RHICmdList, FBlockScanCS::Slot_LevelCountData, LevelCountSRV);
+        BlockScanCS->BindUAV(RHICmdList, FBlockScanCS::Slot_SumData, NextLevelBuffer.UAV);
+        BlockScanCS->SetParameter(RHICmdList, FBlockScanCS::Slot_Params_ElementCount, LevelCount);
+        BlockScanCS->SetParameter(RHICmdList, FBlockScanCS::Slot_Params_DispatchWidth, DispatchCount.X);
+        BlockScanCS->SetParameter(RHICmdList, FBlockScanCS::Slot_Params_LevelIndex, LevelIndex+1);
+        BlockScanCS->DispatchLinear(RHICmdList, DispatchCount, ArgumentBuffer, FRULPrefixSumScan::GetScanArgsOffset(LevelIndex+1));
         BlockScanCS->UnbindBuffers(RHICmdList);
         RHICmdList.EndComputePass();
 
-        // Block sum top level scan
+        LevelBuffer = &NextLevelBuffer;
+        LevelCount  = NextLevelCount;
+        ++LevelIndex;
+    }
 
-        RHICmdList.BeginComputePass(TEXT("RULReduceTopLevelScan"));
-        TShaderMapRef<FRULReduceTopLevelScanCS<ScanDataType, ScanOpType>> TopLevelScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-        TopLevelScanCS->SetShader(RHICmdList);
-        TopLevelScanCS->BindUAV(RHICmdList, TEXT("SumData"), SumBlockBuffer.UAV);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_BlockCount"), BlockGroupCount);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_ScanBlockCount"), ScanBlockGroupCount);
-        DispatchComputeShader(RHICmdList, *TopLevelScanCS, 1, 1, 1);
-        TopLevelScanCS->UnbindBuffers(RHICmdList);
-        RHICmdList.EndComputePass();
+    const int32 ScanLevelCount = FPlatformMath::RoundUpToPowerOfTwo(LevelCount);
 
-        // Write result
-
-        RHICmdList.BeginComputePass(TEXT("RULWriteScanResult"));
-        TShaderMapRef<FRULWriteScanResultCS<ScanDataType>> WriteResultCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-        WriteResultCS->SetShader(RHICmdList);
-        WriteResultCS->BindSRV(RHICmdList, TEXT("SrcData"), SumBlockBuffer.SRV);
-        WriteResultCS->BindUAV(RHICmdList, TEXT("SumData"), ResultBuffer.UAV);
-        WriteResultCS->SetParameter(RHICmdList, TEXT("_ElementCount"), SumBlockBufferCount);
-        WriteResultCS->SetParameter(RHICmdList, TEXT("_ResultIndex"), ResultIndex);
-        DispatchComputeShader(RHICmdList, *WriteResultCS, 1, 1, 1);
-        WriteResultCS->UnbindBuffers(RHICmdList);
-        RHICmdList.EndComputePass();
+    // Top level scan
+
+    RHICmdList.BeginComputePass(TEXT("RULReduceTopLevelScan"));
+    TShaderMapRef<FTopLevelScanCS> TopLevelScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+    TopLevelScanCS->SetShader(RHICmdList);
+    TopLevelScanCS->BindSRV(RHICmdList, FTopLevelScanCS::Slot_LevelCountData, LevelCountSRV);
+    TopLevelScanCS->BindUAV(RHICmdList, FTopLevelScanCS::Slot_SumData, LevelBuffer->UAV);
+    TopLevelScanCS->SetParameter(RHICmdList, FTopLevelScanCS::Slot_Params_BlockCount, LevelCount);
+    TopLevelScanCS->SetParameter(RHICmdList, FTopLevelScanCS::Slot_Params_ScanBlockCount, ScanLevelCount);
+    TopLevelScanCS->SetParameter(RHICmdList, FTopLevelScanCS::Slot_Params_LevelIndex, LevelIndex+1);
+    DispatchComputeShader(RHICmdList, *TopLevelScanCS, 1, 1, 1);
+    TopLevelScanCS->UnbindBuffers(RHICmdList);
+    RHICmdList.EndComputePass();
+
+    // Write result
+
+    RHICmdList.BeginComputePass(TEXT("RULWriteScanResult"));
+    TShaderMapRef<FWriteResultCS> WriteResultCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+    WriteResultCS->SetShader(RHICmdList);
+    WriteResultCS->BindSRV(RHICmdList, FWriteResultCS::Slot_SrcData, LevelBuffer->SRV);
+    WriteResultCS->BindUAV(RHICmdList, FWriteResultCS::Slot_ResultData, ResultBuffer.UAV);
+    WriteResultCS->SetParameter(RHICmdList, FWriteResultCS::Slot_Params_Dimension, DimensionData);
+    WriteResultCS->SetParameter(RHICmdList, FWriteResultCS::Slot_Params_ElementCount, ScanLevelCount+1);
+    WriteResultCS->SetParameter(RHICmdList, FWriteResultCS::Slot_Params_ResultIndex, ResultIndex);
+    DispatchComputeShader(RHICmdList, *WriteResultCS, 1, 1, 1);
+    WriteResultCS->UnbindBuffers(RHICmdList);
+    RHICmdList.EndComputePass();
+}
+
+template<uint32 ScanDataType, uint32 ScanOpType, uint32 bUseTexture>
+int32 FRULReduceScan::ReduceSinglePass(
+    FRHICommandListImmediate& RHICmdList,
+    FShaderResourceViewRHIParamRef SrcDataSRV,
+    FTextureRHIParamRef SourceTexture,
+    FRULRWBufferStructured& ResultBuffer,
+    FIntPoint Dimension,
+    int32 DataStride,
+    int32 ElementCount,
+    int32 ResultIndex,
+    uint32 AdditionalOutputUsage
+    )
+{
+    check(IsInRenderingThread());
+    check(ElementCount > 0);
+    check(ResultBuffer.IsValidIndex(ResultIndex+GetScanOpOutputCount<ScanOpType>()-1));
+    check(GRULReduceCounterBuffer.CounterData.IsValid());
+
+    typedef FRULReduceSinglePassCS<ScanDataType, ScanOpType, bUseTexture> FSinglePassCS;
+
+    const int32 BlockCount = FMath::DivideAndRoundUp(ElementCount, BLOCK_SIZE2);
+    const int32 GroupCount = FMath::Min(BlockCount, SINGLE_PASS_MAX_GROUPS);
+
+    FIntVector4 DimensionData(Dimension.X, Dimension.Y, 0, 0);
+
+    FRULPooledRWBufferStructured PartialBuffer;
+    PartialBuffer.Acquire(DataStride*GetScanOpReducedValueCount<ScanOpType>(), GroupCount, AdditionalOutputUsage);
+
+    RHICmdList.BeginComputePass(TEXT("RULReduceSinglePass"));
+    TShaderMapRef<FSinglePassCS> SinglePassCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+    SinglePassCS->SetShader(RHICmdList);
+    if (bUseTexture)
+    {
+        SinglePassCS->BindTexture(RHICmdList, FSinglePassCS::Slot_SourceTexture, SourceTexture);
     }
     else
     {
-        // Top level scan
+        SinglePassCS->BindSRV(RHICmdList, FSinglePassCS::Slot_SrcData, SrcDataSRV);
+    }
+    SinglePassCS->BindUAV(RHICmdList, FSinglePassCS::Slot_ResultData, ResultBuffer.UAV);
+    SinglePassCS->BindUAV(RHICmdList, FSinglePassCS::Slot_PartialData, PartialBuffer.UAV);
+    SinglePassCS->BindUAV(RHICmdList, FSinglePassCS::Slot_CounterData, GRULReduceCounterBuffer.CounterData.UAV);
+    SinglePassCS->SetParameter(RHICmdList, FSinglePassCS::Slot_Params_Dimension, DimensionData);
+    SinglePassCS->SetParameter(RHICmdList, FSinglePassCS::Slot_Params_ElementCount, ElementCount);
+    SinglePassCS->SetParameter(RHICmdList, FSinglePassCS::Slot_Params_ResultIndex, ResultIndex);
+    SinglePassCS->SetParameter(RHICmdList, FSinglePassCS::Slot_Params_GroupCount, GroupCount);
+    DispatchComputeShader(RHICmdList, *SinglePassCS, GroupCount, 1, 1);
+    SinglePassCS->UnbindBuffers(RHICmdList);
+    RHICmdList.EndComputePass();
 
-        RHICmdList.BeginComputePass(TEXT("RULReduceTopLevelScan"));
-        TShaderMapRef<FRULReduceTopLevelScanCS<ScanDataType, ScanOpType>> TopLevelScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-        TopLevelScanCS->SetShader(RHICmdList);
-        TopLevelScanCS->BindUAV(RHICmdList, TEXT("SumData"), SumBuffer.UAV);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_BlockCount"), BlockCount);
-        TopLevelScanCS->SetParameter(RHICmdList, TEXT("_ScanBlockCount"), ScanBlockCount);
-        DispatchComputeShader(RHICmdList, *TopLevelScanCS, 1, 1, 1);
-        TopLevelScanCS->UnbindBuffers(RHICmdList);
-        RHICmdList.EndComputePass();
+    return GroupCount;
+}
 
-        // Write result
-
-        RHICmdList.BeginComputePass(TEXT("RULWriteScanResult"));
-        TShaderMapRef<FRULWriteScanResultCS<ScanDataType>> WriteResultCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-        WriteResultCS->SetShader(RHICmdList);
-        WriteResultCS->BindSRV(RHICmdList, TEXT("SrcData"), SumBuffer.SRV);
-        WriteResultCS->BindUAV(RHICmdList, TEXT("SumData"), ResultBuffer.UAV);
-        WriteResultCS->SetParameter(RHICmdList, TEXT("_ElementCount"), SumBufferCount);
-        WriteResultCS->SetParameter(RHICmdList, TEXT("_ResultIndex"), ResultIndex);
-        DispatchComputeShader(RHICmdList, *WriteResultCS, 1, 1, 1);
-        WriteResultCS->UnbindBuffers(RHICmdList);
-        RHICmdList.EndComputePass();
+template<uint32 ScanDataType, uint32 ScanOpType>
+int32 FRULReduceScan::ReduceSegmented(
+    FRHICommandListImmediate& RHICmdList,
+    FShaderResourceViewRHIParamRef SrcDataSRV,
+    FShaderResourceViewRHIParamRef SegmentOffsetsSRV,
+    FRULRWBufferStructured& ResultBuffer,
+    int32 DataStride,
+    int32 ElementCount,
+    int32 SegmentCount,
+    uint32 AdditionalOutputUsage
+    )
+{
+    check(IsInRenderingThread());
+    check(IsValidScanDataType<ScanDataType>());
+    check(IsValidScanOpType<ScanOpType>());
+
+    if (! SrcDataSRV || ! SegmentOffsetsSRV || ElementCount < 1 || SegmentCount < 1)
+    {
+        return -1;
     }
 
-    return ScanBlockCount;
+    if (DataStride != GetScanDataTypeStride<ScanDataType>())
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULReduceScan::ReduceSegmented() Data stride (%d) does not match scan data type stride (%d)"),
+            DataStride,
+            GetScanDataTypeStride<ScanDataType>());
+        return -1;
+    }
+
+    const int32 OutputCount = GetScanOpOutputCount<ScanOpType>();
+    const int32 ResultCount = SegmentCount * OutputCount;
+
+    // Reset result buffer if it does not match the required layout
+
+    if (! ResultBuffer.HasLayout(DataStride, ResultCount, AdditionalOutputUsage))
+    {
+        ResultBuffer.Release();
+        ResultBuffer.Initialize(DataStride, ResultCount, AdditionalOutputUsage);
+    }
+
+    typedef FRULReduceSegmentedCS<ScanDataType, ScanOpType> FSegmentedCS;
+
+    // One group per segment, wrapped into the Y dimension
+    // if the segment count exceeds the dispatch group limit
+
+    const FIntPoint DispatchCount = FSegmentedCS::GetLinearDispatchCount(SegmentCount);
+
+    RHICmdList.BeginComputePass(TEXT("RULReduceSegmented"));
+    TShaderMapRef<FSegmentedCS> SegmentedCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+    SegmentedCS->SetShader(RHICmdList);
+    SegmentedCS->BindSRV(RHICmdList, FSegmentedCS::Slot_SrcData, SrcDataSRV);
+    SegmentedCS->BindSRV(RHICmdList, FSegmentedCS::Slot_SegmentOffsets, SegmentOffsetsSRV);
+    SegmentedCS->BindUAV(RHICmdList, FSegmentedCS::Slot_ResultData, ResultBuffer.UAV);
+    SegmentedCS->SetParameter(RHICmdList, FSegmentedCS::Slot_Params_Dimension, FIntVector4(ElementCount, 1, 0, 0));
+    SegmentedCS->SetParameter(RHICmdList, FSegmentedCS::Slot_Params_ElementCount, ElementCount);
+    SegmentedCS->SetParameter(RHICmdList, FSegmentedCS::Slot_Params_SegmentCount, SegmentCount);
+    SegmentedCS->SetParameter(RHICmdList, FSegmentedCS::Slot_Params_GroupCount, DispatchCount.X);
+    DispatchComputeShader(RHICmdList, *SegmentedCS, DispatchCount.X, DispatchCount.Y, 1);
+    SegmentedCS->UnbindBuffers(RHICmdList);
+    RHICmdList.EndComputePass();
+
+    return SegmentCount;
 }
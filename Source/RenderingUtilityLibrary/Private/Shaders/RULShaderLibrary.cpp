@@ -31,12 +31,15 @@
 #include "CanvasTypes.h"
 #include "EngineModule.h"
 #include "HitProxies.h"
+#include "MaterialShared.h"
 #include "MeshPassProcessor.h"
 #include "UniformBuffer.h"
 #include "RHICommandList.h"
 #include "RHIStaticStates.h"
 #include "RHIResources.h"
+#include "RHIGPUReadback.h"
 #include "RenderResource.h"
+#include "TickableObjectRenderThread.h"
 #include "PipelineStateCache.h"
 #include "ScreenRendering.h"
 #include "ShaderParameterUtils.h"
@@ -47,10 +50,19 @@
 #include "GWTTickUtilities.h"
 
 #include "RenderingUtilityLibrary.h"
+#include "RHI/RULRHIBuffer.h"
+#include "RHI/RULRHIRenderTargetPool.h"
+#include "RHI/RULRHIUploadHeap.h"
 #include "RHI/RULRHIUtilityLibrary.h"
+#include "RHI/RULRetainedGeometry.h"
 #include "Shaders/RULShaderDefinitions.h"
+#include "Shaders/RULHeightMapErosion.h"
 #include "Shaders/RULPrefixSumScan.h"
 #include "Shaders/RULReduceScan.h"
+#include "Shaders/RULTextureBlur.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cached Render Target View Count"), STAT_RULCachedSceneViewCount, STATGROUP_RenderingUtilityLibrary);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Created Render Target Views"), STAT_RULCreatedSceneViews, STATGROUP_RenderingUtilityLibrary);
 
 class FRULColorGeometryVertexDeclaration : public FRenderResource
 {
@@ -73,6 +85,202 @@ public:
 
 TGlobalResource<FRULColorGeometryVertexDeclaration> GRULColorGeometryVertexDeclaration;
 
+class FRULEmptyVertexDeclaration : public FRenderResource
+{
+public:
+
+	FVertexDeclarationRHIRef VertexDeclarationRHI;
+
+	virtual void InitRHI() override
+	{
+		FVertexDeclarationElementList Elements;
+		VertexDeclarationRHI = PipelineStateCache::GetOrCreateVertexDeclaration(Elements);
+	}
+	virtual void ReleaseRHI() override
+	{
+		VertexDeclarationRHI.SafeRelease();
+	}
+};
+
+TGlobalResource<FRULEmptyVertexDeclaration> GRULEmptyVertexDeclaration;
+
+// Render thread cache of default render target views.
+//
+// Views are keyed by render target resource and rebuilt whenever the target
+// texture, size or display gamma changes. Entries hold a reference to the
+// render target texture, so a resource allocated at the address of a released
+// one never matches a cached view. Views are released once their texture is
+// only referenced by the cache (the render target was released or resized)
+// or once the render target has not been drawn to for MaxUnusedFrames frames.
+// Entries are trimmed every render frame while the cache is not empty, so
+// released render targets do not stay in memory until the next draw.
+class FRULSceneViewCache : public FRenderResource, public FTickableObjectRenderThread
+{
+public:
+
+    FRULSceneViewCache()
+        : FTickableObjectRenderThread(false, false)
+    {
+    }
+
+    TSharedRef<FSceneView> FindOrCreate(FTextureRenderTarget2DResource* RTResource, const FIntRect& ViewRect)
+    {
+        check(IsInRenderingThread());
+        check(RTResource != nullptr);
+
+        const uint32 CurrentFrame = GFrameNumberRenderThread;
+
+        if (LastTrimFrame != CurrentFrame)
+        {
+            Trim(CurrentFrame);
+        }
+
+        FRHITexture* Texture = RTResource->GetRenderTargetTexture();
+        const FIntPoint Size = ViewRect.Size();
+        const float Gamma = RTResource->GetDisplayGamma();
+
+        FEntry* Entry = Entries.Find(RTResource);
+
+        if (! Entry || Entry->Texture.GetReference() != Texture || Entry->Size != Size || Entry->Gamma != Gamma)
+        {
+            if (! Entry)
+            {
+                Entry = &Entries.Emplace(RTResource);
+                INC_DWORD_STAT(STAT_RULCachedSceneViewCount);
+
+                // Register on first use, ticks are skipped while the cache is empty
+                if (! bRegistered)
+                {
+                    Register();
+                    bRegistered = true;
+                }
+            }
+
+            Entry->View = CreateView(RTResource, ViewRect, Gamma);
+            Entry->Texture = Texture;
+            Entry->Size = Size;
+            Entry->Gamma = Gamma;
+
+            INC_DWORD_STAT(STAT_RULCreatedSceneViews);
+        }
+
+        Entry->LastUsedFrame = CurrentFrame;
+
+        return Entry->View.ToSharedRef();
+    }
+
+    void Release(FTextureRenderTarget2DResource* RTResource)
+    {
+        if (Entries.Remove(RTResource) > 0)
+        {
+            DEC_DWORD_STAT(STAT_RULCachedSceneViewCount);
+        }
+    }
+
+    virtual void ReleaseDynamicRHI() override
+    {
+        DEC_DWORD_STAT_BY(STAT_RULCachedSceneViewCount, Entries.Num());
+        Entries.Empty();
+
+        if (bRegistered)
+        {
+            Unregister();
+            bRegistered = false;
+        }
+    }
+
+    virtual void Tick(float DeltaTime) override
+    {
+        check(IsInRenderingThread());
+
+        const uint32 CurrentFrame = GFrameNumberRenderThread;
+
+        if (LastTrimFrame != CurrentFrame)
+        {
+            Trim(CurrentFrame);
+        }
+    }
+
+    virtual bool IsTickable() const override
+    {
+        return Entries.Num() > 0;
+    }
+
+    virtual TStatId GetStatId() const override
+    {
+        RETURN_QUICK_DECLARE_CYCLE_STAT(FRULSceneViewCache, STATGROUP_Tickables);
+    }
+
+private:
+
+    struct FEntry
+    {
+        TSharedPtr<FSceneView> View;
+        FTextureRHIRef Texture;
+        FIntPoint Size = FIntPoint::ZeroValue;
+        float Gamma = 0.f;
+        uint32 LastUsedFrame = 0;
+    };
+
+    static const uint32 MaxUnusedFrames = 60;
+
+    TMap<FTextureRenderTarget2DResource*, FEntry> Entries;
+    uint32 LastTrimFrame = 0;
+    bool bRegistered = false;
+
+    void Trim(uint32 CurrentFrame)
+    {
+        LastTrimFrame = CurrentFrame;
+
+        for (auto It = Entries.CreateIterator(); It; ++It)
+        {
+            const FEntry& Entry(It.Value());
+
+            const bool bIsReleased = ! Entry.Texture.IsValid() || Entry.Texture->GetRefCount() == 1;
+            const bool bIsUnused = (CurrentFrame - Entry.LastUsedFrame) > MaxUnusedFrames;
+
+            if (bIsReleased || bIsUnused)
+            {
+                It.RemoveCurrent();
+                DEC_DWORD_STAT(STAT_RULCachedSceneViewCount);
+            }
+        }
+    }
+
+    static TSharedRef<FSceneView> CreateView(FTextureRenderTarget2DResource* RTResource, const FIntRect& ViewRect, float Gamma)
+    {
+        // Create a new view family
+
+        FSceneViewFamily* ViewFamily = new FSceneViewFamily(
+            FSceneViewFamily::ConstructionValues(
+                RTResource,
+                nullptr,
+                FEngineShowFlags(ESFIM_Game)
+                )
+                .SetWorldTimes(0.f, 0.f, 0.f)
+                .SetGammaCorrection(Gamma)
+            );
+
+        // Create a new view
+
+        FSceneViewInitOptions ViewInitOptions;
+        ViewInitOptions.ViewFamily = ViewFamily;
+        ViewInitOptions.SetViewRectangle(ViewRect);
+        ViewInitOptions.ViewOrigin = FVector::ZeroVector;
+        ViewInitOptions.ViewRotationMatrix = FMatrix::Identity;
+        ViewInitOptions.ProjectionMatrix = FMatrix::Identity;
+        ViewInitOptions.BackgroundColor = FLinearColor::Black;
+        ViewInitOptions.OverlayColor = FLinearColor::White;
+        FSceneView* View = new FSceneView(ViewInitOptions);
+
+        // Create auto-delete view reference
+
+        return TSharedRef<FSceneView>(View, [](FSceneView* ViewToDelete){ delete ViewToDelete->Family; delete ViewToDelete; });
+    }
+};
+
+TGlobalResource<FRULSceneViewCache> GRULSceneViewCache;
+
 template<uint32 bEnableVertexColor>
 class TRULShaderDrawGeometryVS : public FRULBaseVertexShader
 {
@@ -198,7 +406,13 @@ class FRULShaderDrawQuadVS : public FRULBaseVertexShader
         )
 
     RUL_DECLARE_SHADER_PARAMETERS_0(UAV,,)
-    RUL_DECLARE_SHADER_PARAMETERS_0(Value,,)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_QuadDataOffsets", Params_QuadDataOffsets
+        )
 };
 
 IMPLEMENT_SHADER_TYPE(, FRULShaderDrawQuadVS, TEXT("/Plugin/RenderingUtilityLibrary/Private/RULDrawGeometryVSPS.usf"), TEXT("DrawQuadVS"), SF_Vertex);
@@ -216,6 +430,33 @@ class FRULShaderDrawPolyVS : public FRULBaseVertexShader
 
 IMPLEMENT_SHADER_TYPE(, FRULShaderDrawPolyVS, TEXT("/Plugin/RenderingUtilityLibrary/Private/RULDrawGeometryVSPS.usf"), TEXT("DrawPolyVS"), SF_Vertex);
 
+class FRULShaderDrawPolyInstanceVS : public FRULBaseVertexShader
+{
+    typedef FRULBaseVertexShader FBaseType;
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_DEFAULT_STATICS(FRULShaderDrawPolyInstanceVS, Global, true)
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "PolyGeomData", PolyGeomData,
+        "PolyTransformData", PolyTransformData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_0(UAV,,)
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_PolyDataOffsets", Params_PolyDataOffsets,
+        "_PolySides", Params_PolySides
+        )
+};
+
+IMPLEMENT_SHADER_TYPE(, FRULShaderDrawPolyInstanceVS, TEXT("/Plugin/RenderingUtilityLibrary/Private/RULDrawGeometryVSPS.usf"), TEXT("DrawPolyInstanceVS"), SF_Vertex);
+
 class FRULShaderAutoLevelPS : public FRULBasePixelShader
 {
     typedef FRULBasePixelShader FBaseType;
@@ -348,6 +589,14 @@ ERenderTargetActions URULShaderLibrary::GetRenderTargetActions(FRULShaderDrawCon
     }
 }
 
+bool URULShaderLibrary::CanStartOnSwapTarget(FRULShaderDrawConfig DrawConfig)
+{
+    // Only opaque passes are independent of target contents. Clearing only
+    // applies to the first pass, repeat passes blending into the render
+    // target would otherwise read its uncleared contents.
+    return DrawConfig.BlendType == ERULShaderDrawBlendType::DB_Opaque;
+}
+
 bool URULShaderLibrary::IsValidSwapTarget(UTextureRenderTarget2D* RTT0, UTextureRenderTarget2D* RTT1)
 {
     return (
@@ -383,35 +632,47 @@ TSharedRef<FSceneView> URULShaderLibrary::CreateDefaultRTView(
 
 	ViewRect = FIntRect(FIntPoint(0, 0), RTResource->GetSizeXY());
 
-	// Create a new view family
+    // Find cached view or create a new one if the render target has changed
 
-	FSceneViewFamily* ViewFamily = new FSceneViewFamily(
-        FSceneViewFamily::ConstructionValues(
-            RTResource,
-            nullptr,
-            FEngineShowFlags(ESFIM_Game)
-            )
-            .SetWorldTimes(0.f, 0.f, 0.f)
-            .SetGammaCorrection(RTResource->GetDisplayGamma())
-        );
+    return GRULSceneViewCache.FindOrCreate(RTResource, ViewRect);
+}
+
+void URULShaderLibrary::ReleaseCachedRTView_RT(FTextureRenderTarget2DResource* RTResource)
+{
+    check(IsInRenderingThread());
+    GRULSceneViewCache.Release(RTResource);
+}
+
+FTexture2DRHIRef FRULShaderDrawContext::GetSwapTexture(FTexture2DRHIParamRef TargetTexture)
+{
+    check(TargetTexture != nullptr);
+
+    for (const FTexture2DRHIRef& SwapTexture : SwapTextures)
+    {
+        if (SwapTexture != TargetTexture && URULShaderLibrary::IsValidSwapTarget_RT(TargetTexture, SwapTexture))
+        {
+            return SwapTexture;
+        }
+    }
 
-	// Create a new view
+    FTexture2DRHIRef SwapTexture = FRULRHIRenderTargetPool::Get().AcquireSwapTexture(TargetTexture);
+    SwapTextures.Emplace(SwapTexture);
 
-	FSceneViewInitOptions ViewInitOptions;
-	ViewInitOptions.ViewFamily = ViewFamily;
-	ViewInitOptions.SetViewRectangle(ViewRect);
-	ViewInitOptions.ViewOrigin = FVector::ZeroVector;
-	ViewInitOptions.ViewRotationMatrix = FMatrix::Identity;
-	ViewInitOptions.ProjectionMatrix = FMatrix::Identity;
-	ViewInitOptions.BackgroundColor = FLinearColor::Black;
-	ViewInitOptions.OverlayColor = FLinearColor::White;
-	FSceneView* View = new FSceneView(ViewInitOptions);
+    return SwapTexture;
+}
 
-    // Create auto-delete view reference
+void FRULShaderDrawContext::Reset()
+{
+    // Return batch swap textures to the render target pool
 
-    TSharedRef<FSceneView> ViewRef(View, [](FSceneView* ViewToDelete){ delete ViewToDelete->Family; });
+    for (FTexture2DRHIRef& SwapTexture : SwapTextures)
+    {
+        FRULRHIRenderTargetPool::Get().Release(SwapTexture);
+    }
 
-    return MoveTemp(ViewRef);
+    SwapTextures.Empty();
+    bUniformExpressionsUpdated = false;
+    bSystemTexturesInitialized = false;
 }
 
 void URULShaderLibrary::BindMaterialInstanceParameterCollection(
@@ -969,118 +1230,132 @@ void URULShaderLibrary::DrawGeometryColors(
     );
 }
 
-void URULShaderLibrary::DrawGeometry_RT(
-    FRHICommandListImmediate& RHICmdList,
-    ERHIFeatureLevel::Type FeatureLevel,
-    FTextureRenderTarget2DResource* RenderTargetResource,
-    FRULShaderDrawConfig DrawConfig,
-    FIntPoint DrawSize,
+FRULGeometryHandle URULShaderLibrary::CreateGeometryHandle(
     const TArray<FVector>& Vertices,
     const TArray<int32>& Indices,
-    const TArray<FColor>* Colors
+    const TArray<FColor>& Colors
     )
 {
-    check(IsInRenderingThread());
+    FRULGeometryHandle GeometryHandle;
 
-    if (! RenderTargetResource)
+    if (Vertices.Num() < 3)
     {
-        return;
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::CreateGeometryHandle() ABORTED, VERTEX COUNT < 3"));
+        return GeometryHandle;
     }
 
-    // Prepare render target texture and resolve target
-    FTextureRHIParamRef TextureRTV = RenderTargetResource->GetRenderTargetTexture();
-    FTextureRHIParamRef TextureRSV = RenderTargetResource->TextureRHI;
-
-    if (! TextureRTV || ! TextureRSV)
+    if (Indices.Num() < 3)
     {
-        return;
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::CreateGeometryHandle() ABORTED, INDEX COUNT < 3"));
+        return GeometryHandle;
     }
 
-    bool bUseColorBuffer = (Colors && Colors->Num() == Vertices.Num());
-
-    // Prepare graphics pipelane
-
-    FRULBaseVertexShader* VSShader;
-    TShaderMapRef<FRULShaderDrawGeometryPS> PSShader(GetGlobalShaderMap(FeatureLevel));
-
-    FGraphicsPipelineStateInitializer GraphicsPSOInit;
-    SetupDefaultGraphicsPSOInit(GraphicsPSOInit, PT_TriangleList, DrawConfig);
-    GraphicsPSOInit.BoundShaderState.PixelShaderRHI = GETSAFERHISHADER_PIXEL(*PSShader);
+    const int32 VertexCount = Vertices.Num();
 
-    if (bUseColorBuffer)
-    {
-        VSShader = *TShaderMapRef<TRULShaderDrawGeometryVS<1>>(GetGlobalShaderMap(FeatureLevel));
-        GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GRULColorGeometryVertexDeclaration.VertexDeclarationRHI;
-        GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VSShader->GetVertexShader();
-    }
-    else
+    for (int32 i=0; i<Indices.Num(); ++i)
     {
-        VSShader = *TShaderMapRef<TRULShaderDrawGeometryVS<0>>(GetGlobalShaderMap(FeatureLevel));
-        GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GetVertexDeclarationFVector3();
-        GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VSShader->GetVertexShader();
+        if (Indices[i] < 0 || Indices[i] >= VertexCount)
+        {
+            UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::CreateGeometryHandle() ABORTED, INDEX %d (%d) OUT OF VERTEX RANGE (%d)"), i, Indices[i], VertexCount);
+            return GeometryHandle;
+        }
     }
 
-    // Render pass
+    GeometryHandle.SharedRef = FRULGeometryHandle::FSharedRefType(new FRULRetainedGeometry);
 
-    FRHIRenderPassInfo RPInfo(TextureRTV, GetRenderTargetActions(DrawConfig), TextureRSV);
-    TransitionRenderPassTargets(RHICmdList, RPInfo);
-    RHICmdList.BeginRenderPass(RPInfo, TEXT("RULShaderLibrary_DrawGeometry"));
+    struct FRenderParameter
     {
-        // Set graphics pipeline
+        FRULGeometryHandle::FSharedRefType GeometryRef;
+        TArray<FVector> Vertices;
+        TArray<int32> Indices;
+        TArray<FColor> Colors;
+    };
 
-        RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
-        SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+    FRenderParameter RenderParameter = {
+        GeometryHandle.SharedRef,
+        Vertices,
+        Indices,
+        Colors
+        };
 
-        // Bind shader parameters
+    ENQUEUE_RENDER_COMMAND(RULShaderLibrary_CreateGeometryHandle)(
+        [RenderParameter](FRHICommandListImmediate& RHICmdList)
+        {
+            RenderParameter.GeometryRef->Initialize_RT(
+                RenderParameter.Vertices,
+                RenderParameter.Indices,
+                &RenderParameter.Colors
+                );
+        }
+    );
 
-        FBox2D DrawBounds(FVector2D(0, 0), DrawSize);
-        FVector2D DrawScale(FVector2D::UnitVector/DrawBounds.GetExtent());
-        FVector2D DrawOffset(-DrawBounds.GetCenter()*DrawScale);
-        FVector4 DrawScaleBias(DrawScale.X, DrawScale.Y, DrawOffset.X, DrawOffset.Y);
+    return GeometryHandle;
+}
 
-        VSShader->SetParameter(RHICmdList, TEXT("_DrawScaleBias"), DrawScaleBias);
+void URULShaderLibrary::ReleaseGeometryHandle(FRULGeometryHandle& GeometryHandle)
+{
+    if (! GeometryHandle.IsValid())
+    {
+        return;
+    }
 
-        // Draw primitives
+    FRULGeometryHandle::FSharedRefType GeometryRef(GeometryHandle.SharedRef);
+    GeometryHandle.SharedRef.Reset();
 
-        FRULRHIUtilityLibrary::DrawTriangleList(RHICmdList, Vertices, Indices, Colors);
+    // Release on the render thread after previously enqueued draws
 
-        VSShader->UnbindBuffers(RHICmdList);
-    }
-    RHICmdList.EndRenderPass();
+    ENQUEUE_RENDER_COMMAND(RULShaderLibrary_ReleaseGeometryHandle)(
+        [GeometryRef](FRHICommandListImmediate& RHICmdList)
+        {
+            GeometryRef->Release_RT();
+        }
+    );
 }
 
-void URULShaderLibrary::DrawTexture(
+bool URULShaderLibrary::IsValidGeometryHandle(const FRULGeometryHandle& GeometryHandle)
+{
+    return GeometryHandle.IsValid();
+}
+
+void URULShaderLibrary::DrawGeometryHandle(
     UObject* WorldContextObject,
-    UTexture* SourceTexture,
     UTextureRenderTarget2D* RenderTarget,
     FRULShaderDrawConfig DrawConfig,
+    FIntPoint DrawSize,
+    const FRULGeometryHandle& GeometryHandle,
     UGWTTickEvent* CallbackEvent
     )
 {
-	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
     FTextureRenderTarget2DResource* RenderTargetResource = nullptr;
 
     if (! IsValid(World))
     {
-        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawTexture() ABORTED, INVALID WORLD CONTEXT OBJECT"));
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawGeometryHandle() ABORTED, INVALID WORLD CONTEXT OBJECT"));
         return;
     }
-    else
+
     if (! World->Scene)
     {
-        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawTexture() ABORTED, INVALID WORLD SCENE"));
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawGeometryHandle() ABORTED, INVALID WORLD SCENE"));
         return;
     }
-    else
-    if (! IsValid(SourceTexture))
+
+    if (! IsValid(RenderTarget))
     {
-        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawTexture() ABORTED, INVALID TEXTURE"));
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawGeometryHandle() ABORTED, INVALID RENDER TARGET"));
         return;
     }
-    else
-    if (! IsValid(RenderTarget))
+
+    if (! GeometryHandle.IsValid())
     {
-        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawTexture() ABORTED, INVALID RENDER TARGET"));
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawGeometryHandle() ABORTED, INVALID GEOMETRY HANDLE"));
+        return;
+    }
+
+    if (DrawSize.X <= 0 || DrawSize.Y <= 0)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawGeometryHandle() ABORTED, INVALID DRAW SIZE"));
         return;
     }
 
@@ -1088,16 +1363,230 @@ void URULShaderLibrary::DrawTexture(
 
     if (! RenderTargetResource)
     {
-        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawTexture() ABORTED, INVALID RENDER TARGET TEXTURE RESOURCE"));
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawGeometryHandle() ABORTED, INVALID RENDER TARGET TEXTURE RESOURCE"));
         return;
     }
 
-    World->SendAllEndOfFrameUpdates();
-
     struct FRenderParameter
     {
         ERHIFeatureLevel::Type FeatureLevel;
-        FTexture* SourceTexture;
+        FTextureRenderTarget2DResource* RenderTargetResource;
+        FRULShaderDrawConfig DrawConfig;
+        FIntPoint DrawSize;
+        FRULGeometryHandle::FSharedRefType GeometryRef;
+        UGWTTickEvent* CallbackEvent;
+    };
+
+    FRenderParameter RenderParameter = {
+        World->Scene->GetFeatureLevel(),
+        RenderTargetResource,
+        DrawConfig,
+        DrawSize,
+        GeometryHandle.SharedRef,
+        CallbackEvent
+        };
+
+    ENQUEUE_RENDER_COMMAND(RULShaderLibrary_DrawGeometryHandle)(
+        [RenderParameter](FRHICommandListImmediate& RHICmdList)
+        {
+            URULShaderLibrary::DrawGeometryHandle_RT(
+                RHICmdList,
+                RenderParameter.FeatureLevel,
+                RenderParameter.RenderTargetResource,
+                RenderParameter.DrawConfig,
+                RenderParameter.DrawSize,
+                *RenderParameter.GeometryRef
+                );
+            FGWTTickEventRef(RenderParameter.CallbackEvent).EnqueueCallback();
+        }
+    );
+}
+
+void URULShaderLibrary::DrawGeometry_RT(
+    FRHICommandListImmediate& RHICmdList,
+    ERHIFeatureLevel::Type FeatureLevel,
+    FTextureRenderTarget2DResource* RenderTargetResource,
+    FRULShaderDrawConfig DrawConfig,
+    FIntPoint DrawSize,
+    const TArray<FVector>& Vertices,
+    const TArray<int32>& Indices,
+    const TArray<FColor>* Colors
+    )
+{
+    check(IsInRenderingThread());
+
+    bool bUseColorBuffer = (Colors && Colors->Num() == Vertices.Num());
+
+    DrawGeometryPass_RT(
+        RHICmdList,
+        FeatureLevel,
+        RenderTargetResource,
+        DrawConfig,
+        DrawSize,
+        bUseColorBuffer,
+        [&](FRHICommandList& DrawCmdList)
+        {
+            FRULRHIUtilityLibrary::DrawTriangleList(DrawCmdList, Vertices, Indices, Colors);
+        }
+        );
+}
+
+void URULShaderLibrary::DrawGeometryPass_RT(
+    FRHICommandListImmediate& RHICmdList,
+    ERHIFeatureLevel::Type FeatureLevel,
+    FTextureRenderTarget2DResource* RenderTargetResource,
+    const FRULShaderDrawConfig& DrawConfig,
+    FIntPoint DrawSize,
+    bool bUseColorBuffer,
+    TFunctionRef<void(FRHICommandList&)> DrawPrimitives
+    )
+{
+    check(IsInRenderingThread());
+
+    if (! RenderTargetResource)
+    {
+        return;
+    }
+
+    // Prepare render target texture and resolve target
+    FTextureRHIParamRef TextureRTV = RenderTargetResource->GetRenderTargetTexture();
+    FTextureRHIParamRef TextureRSV = RenderTargetResource->TextureRHI;
+
+    if (! TextureRTV || ! TextureRSV)
+    {
+        return;
+    }
+
+    // Prepare graphics pipelane
+
+    FRULBaseVertexShader* VSShader;
+    TShaderMapRef<FRULShaderDrawGeometryPS> PSShader(GetGlobalShaderMap(FeatureLevel));
+
+    FGraphicsPipelineStateInitializer GraphicsPSOInit;
+    SetupDefaultGraphicsPSOInit(GraphicsPSOInit, PT_TriangleList, DrawConfig);
+    GraphicsPSOInit.BoundShaderState.PixelShaderRHI = GETSAFERHISHADER_PIXEL(*PSShader);
+
+    if (bUseColorBuffer)
+    {
+        VSShader = *TShaderMapRef<TRULShaderDrawGeometryVS<1>>(GetGlobalShaderMap(FeatureLevel));
+        GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GRULColorGeometryVertexDeclaration.VertexDeclarationRHI;
+        GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VSShader->GetVertexShader();
+    }
+    else
+    {
+        VSShader = *TShaderMapRef<TRULShaderDrawGeometryVS<0>>(GetGlobalShaderMap(FeatureLevel));
+        GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GetVertexDeclarationFVector3();
+        GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VSShader->GetVertexShader();
+    }
+
+    // Render pass
+
+    FRHIRenderPassInfo RPInfo(TextureRTV, GetRenderTargetActions(DrawConfig), TextureRSV);
+    TransitionRenderPassTargets(RHICmdList, RPInfo);
+    RHICmdList.BeginRenderPass(RPInfo, TEXT("RULShaderLibrary_DrawGeometry"));
+    {
+        // Set graphics pipeline
+
+        RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+        SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+
+        // Bind shader parameters
+
+        FBox2D DrawBounds(FVector2D(0, 0), DrawSize);
+        FVector2D DrawScale(FVector2D::UnitVector/DrawBounds.GetExtent());
+        FVector2D DrawOffset(-DrawBounds.GetCenter()*DrawScale);
+        FVector4 DrawScaleBias(DrawScale.X, DrawScale.Y, DrawOffset.X, DrawOffset.Y);
+
+        VSShader->SetParameter(RHICmdList, TRULShaderDrawGeometryVS<0>::Slot_Params_DrawScaleBias, DrawScaleBias);
+
+        // Draw primitives
+
+        DrawPrimitives(RHICmdList);
+
+        VSShader->UnbindBuffers(RHICmdList);
+    }
+    RHICmdList.EndRenderPass();
+}
+
+void URULShaderLibrary::DrawGeometryHandle_RT(
+    FRHICommandListImmediate& RHICmdList,
+    ERHIFeatureLevel::Type FeatureLevel,
+    FTextureRenderTarget2DResource* RenderTargetResource,
+    FRULShaderDrawConfig DrawConfig,
+    FIntPoint DrawSize,
+    const FRULRetainedGeometry& Geometry
+    )
+{
+    check(IsInRenderingThread());
+
+    if (! Geometry.IsValid())
+    {
+        return;
+    }
+
+    DrawGeometryPass_RT(
+        RHICmdList,
+        FeatureLevel,
+        RenderTargetResource,
+        DrawConfig,
+        DrawSize,
+        Geometry.HasColors(),
+        [&](FRHICommandList& DrawCmdList)
+        {
+            Geometry.Draw_RT(DrawCmdList);
+        }
+        );
+}
+
+void URULShaderLibrary::DrawTexture(
+    UObject* WorldContextObject,
+    UTexture* SourceTexture,
+    UTextureRenderTarget2D* RenderTarget,
+    FRULShaderDrawConfig DrawConfig,
+    UGWTTickEvent* CallbackEvent
+    )
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+    FTextureRenderTarget2DResource* RenderTargetResource = nullptr;
+
+    if (! IsValid(World))
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawTexture() ABORTED, INVALID WORLD CONTEXT OBJECT"));
+        return;
+    }
+    else
+    if (! World->Scene)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawTexture() ABORTED, INVALID WORLD SCENE"));
+        return;
+    }
+    else
+    if (! IsValid(SourceTexture))
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawTexture() ABORTED, INVALID TEXTURE"));
+        return;
+    }
+    else
+    if (! IsValid(RenderTarget))
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawTexture() ABORTED, INVALID RENDER TARGET"));
+        return;
+    }
+
+    RenderTargetResource = static_cast<FTextureRenderTarget2DResource*>(RenderTarget->GameThread_GetRenderTargetResource());
+
+    if (! RenderTargetResource)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawTexture() ABORTED, INVALID RENDER TARGET TEXTURE RESOURCE"));
+        return;
+    }
+
+    World->SendAllEndOfFrameUpdates();
+
+    struct FRenderParameter
+    {
+        ERHIFeatureLevel::Type FeatureLevel;
+        FTexture* SourceTexture;
         FTextureRenderTarget2DResource* RenderTargetResource;
         FRULShaderDrawConfig DrawConfig;
         UGWTTickEvent* CallbackEvent;
@@ -1131,7 +1620,8 @@ void URULShaderLibrary::DrawTexture_RT(
     ERHIFeatureLevel::Type FeatureLevel,
     FTexture* SourceTexture,
     FTextureRenderTarget2DResource* RenderTargetResource,
-    FRULShaderDrawConfig DrawConfig
+    FRULShaderDrawConfig DrawConfig,
+    FRULShaderDrawContext* DrawContext
     )
 {
     check(IsInRenderingThread());
@@ -1155,7 +1645,15 @@ void URULShaderLibrary::DrawTexture_RT(
     RHICmdList.SetViewport(ViewRect.Min.X, ViewRect.Min.Y, 0.0f, ViewRect.Max.X, ViewRect.Max.Y, 1.0f);
 
     // Safe check render pass
-    GetRendererModule().InitializeSystemTextures(RHICmdList);
+    if (! DrawContext || ! DrawContext->bSystemTexturesInitialized)
+    {
+        GetRendererModule().InitializeSystemTextures(RHICmdList);
+
+        if (DrawContext)
+        {
+            DrawContext->bSystemTexturesInitialized = true;
+        }
+    }
     check(RHICmdList.IsOutsideRenderPass());
 
     // Render pass with the specified render target
@@ -1307,7 +1805,8 @@ void URULShaderLibrary::ApplyMaterial_RT(
     ERHIFeatureLevel::Type FeatureLevel,
     FTextureRenderTarget2DResource* RenderTargetResource,
     const FMaterialRenderProxy* MaterialRenderProxy,
-    FRULShaderDrawConfig DrawConfig
+    FRULShaderDrawConfig DrawConfig,
+    FRULShaderDrawContext* DrawContext
     )
 {
     check(IsInRenderingThread());
@@ -1328,10 +1827,13 @@ void URULShaderLibrary::ApplyMaterial_RT(
         return;
     }
 
-    // Update deferred expression cache
+    // Update deferred expression cache, batched operations update all materials up front
 
-    MaterialRenderProxy->UpdateUniformExpressionCacheIfNeeded(FeatureLevel);
-    FMaterialRenderProxy::UpdateDeferredCachedUniformExpressions();
+    if (! DrawContext || ! DrawContext->bUniformExpressionsUpdated)
+    {
+        MaterialRenderProxy->UpdateUniformExpressionCacheIfNeeded(FeatureLevel);
+        FMaterialRenderProxy::UpdateDeferredCachedUniformExpressions();
+    }
 
 	// Create default render target view
 
@@ -1499,7 +2001,8 @@ void URULShaderLibrary::ApplyMaterialFilter_RT(
     FRULShaderTextureParameterInputResource SourceTextureResource,
     FTextureRenderTarget2DResource* RenderTargetResource,
     FTextureRenderTarget2DResource* SwapTargetResource,
-    const FMaterialRenderProxy* MaterialRenderProxy
+    const FMaterialRenderProxy* MaterialRenderProxy,
+    FRULShaderDrawContext* DrawContext
     )
 {
     check(IsInRenderingThread());
@@ -1512,7 +2015,7 @@ void URULShaderLibrary::ApplyMaterialFilter_RT(
     }
 
     FTexture2DRHIRef SwapTextureRTV;
-    FTexture2DRHIRef SwapTextureRSV;
+    FRULPooledRenderTarget PooledSwapTexture;
     FTexture2DRHIRef SourceTexture = SourceTextureResource.GetTextureParamRef_RT();
     FTexture2DRHIRef TargetTexture = RenderTargetResource->GetRenderTargetTexture();
 
@@ -1521,10 +2024,13 @@ void URULShaderLibrary::ApplyMaterialFilter_RT(
         return;
     }
 
-    // Update deferred expression cache
+    // Update deferred expression cache, batched operations update all materials up front
 
-    MaterialRenderProxy->UpdateUniformExpressionCacheIfNeeded(FeatureLevel);
-    FMaterialRenderProxy::UpdateDeferredCachedUniformExpressions();
+    if (! DrawContext || ! DrawContext->bUniformExpressionsUpdated)
+    {
+        MaterialRenderProxy->UpdateUniformExpressionCacheIfNeeded(FeatureLevel);
+        FMaterialRenderProxy::UpdateDeferredCachedUniformExpressions();
+    }
 
     const bool bIsMultiPass = RepeatCount > 0;
 
@@ -1545,30 +2051,34 @@ void URULShaderLibrary::ApplyMaterialFilter_RT(
             }
         }
 
-        // Create new swap texture if no swap texture is supplied
+        // Use batch swap texture if no swap texture is supplied
+        if (! SwapTextureRTV.IsValid() && DrawContext)
+        {
+            SwapTextureRTV = DrawContext->GetSwapTexture(TargetTexture);
+        }
+
+        // Acquire pooled swap texture if no swap texture is supplied
         if (! SwapTextureRTV.IsValid())
         {
-            const uint32 FlagsMask = ~(TexCreate_RenderTargetable | TexCreate_ResolveTargetable | TexCreate_ShaderResource);
-            FRHIResourceCreateInfo CreateInfo(TargetTexture->GetClearBinding());
-            RHICreateTargetableShaderResource2D(
-                TargetTexture->GetSizeX(),
-                TargetTexture->GetSizeY(),
-                TargetTexture->GetFormat(),
-                1,
-                TargetTexture->GetFlags() & FlagsMask,
-                TexCreate_RenderTargetable,
-                false,
-                CreateInfo,
-                SwapTextureRTV,
-                SwapTextureRSV,
-                TargetTexture->GetNumSamples()
-                );
+            PooledSwapTexture.AcquireSwapTexture(TargetTexture);
+            SwapTextureRTV = PooledSwapTexture.Texture;
         }
     }
 
+    // Plan ping-pong pass parity so the last pass writes to the render target.
+    // On odd repeat count the first pass is written to the swap texture instead,
+    // if it does not depend on existing render target contents.
+    const bool bStartOnSwap = (
+        bIsMultiPass &&
+        (RepeatCount % 2) == 1 &&
+        CanStartOnSwapTarget(DrawConfig) &&
+        SourceTexture != SwapTextureRTV
+        );
+
     // Prepare render target texture and resolve target
     FTextureRHIParamRef TextureRTV = TargetTexture;
     FTextureRHIParamRef TextureRSV = RenderTargetResource->TextureRHI;
+    FTextureRHIParamRef FirstPassRTV = bStartOnSwap ? FTextureRHIParamRef(SwapTextureRTV) : TextureRTV;
     FSamplerStateRHIParamRef TextureSampler = TStaticSamplerState<SF_Bilinear,AM_Clamp,AM_Clamp,AM_Clamp>::GetRHI();
 
 	// Create default render target view
@@ -1595,7 +2105,7 @@ void URULShaderLibrary::ApplyMaterialFilter_RT(
 
     // Render pass
 
-    FRHIRenderPassInfo RPInfo(TextureRTV, GetRenderTargetActions(DrawConfig));
+    FRHIRenderPassInfo RPInfo(FirstPassRTV, GetRenderTargetActions(DrawConfig));
     TransitionRenderPassTargets(RHICmdList, RPInfo);
     RHICmdList.BeginRenderPass(RPInfo, TEXT("RULShaderLibrary_ApplyMaterialFilter"));
     {
@@ -1607,7 +2117,7 @@ void URULShaderLibrary::ApplyMaterialFilter_RT(
         // Bind shader parameters
 
         SetupMaterialParameters(RHICmdList, FeatureLevel, *VSShader, PSShader, *MaterialRenderProxy, *View);
-        PSShader->BindTexture(RHICmdList, TEXT("SourceMap"), TEXT("SourceMapSampler"), SourceTexture, TextureSampler);
+        PSShader->BindTexture(RHICmdList, TRULShaderDrawScreenMS<0>::Slot_SourceMap, TRULShaderDrawScreenMS<0>::Slot_SourceMapSampler, SourceTexture, TextureSampler);
 
         // Draw primitives
 
@@ -1622,8 +2132,8 @@ void URULShaderLibrary::ApplyMaterialFilter_RT(
     // Draw multi-pass if required
     if (bIsMultiPass)
     {
-        FTextureRHIParamRef TextureRTV0 = TextureRTV;
-        FTextureRHIParamRef TextureRTV1 = SwapTextureRTV;
+        FTextureRHIParamRef TextureRTV0 = FirstPassRTV;
+        FTextureRHIParamRef TextureRTV1 = bStartOnSwap ? TextureRTV : FTextureRHIParamRef(SwapTextureRTV);
 
         check(TextureRTV0 != nullptr);
         check(TextureRTV1 != nullptr);
@@ -1640,7 +2150,7 @@ void URULShaderLibrary::ApplyMaterialFilter_RT(
             RHICmdList.BeginRenderPass(SwapRPInfo, TEXT("RULShaderLibrary_ApplyMaterialFilter"));
             {
                 // Bind swap texture
-                PSShader->BindTexture(RHICmdList, TEXT("SourceMap"), TEXT("SourceMapSampler"), TextureRTV0, TextureSampler);
+                PSShader->BindTexture(RHICmdList, TRULShaderDrawScreenMS<0>::Slot_SourceMap, TRULShaderDrawScreenMS<0>::Slot_SourceMapSampler, TextureRTV0, TextureSampler);
                 // Draw primitives
                 RHICmdList.DrawPrimitive(0, 2, 1);
                 // Unbind shader parameters
@@ -1655,7 +2165,8 @@ void URULShaderLibrary::ApplyMaterialFilter_RT(
         // Unbind vertex shader parameters
         VSShader->UnbindBuffers(RHICmdList);
 
-        // Make sure TextureRTV has the last drawn render target
+        // Make sure TextureRTV has the last drawn render target,
+        // only required if pass parity could not be planned
         if (TextureRTV0 != TextureRTV)
         {
             RHICmdList.CopyToResolveTarget(
@@ -1810,7 +2321,7 @@ void URULShaderLibrary::ApplyMultiParametersMaterial_RT(
     }
 
     FTexture2DRHIRef SwapTextureRTV;
-    FTexture2DRHIRef SwapTextureRSV;
+    FRULPooledRenderTarget PooledSwapTexture;
     FTexture2DRHIRef TargetTexture = RenderTargetResource->GetRenderTargetTexture();
 
     if (! TargetTexture.IsValid())
@@ -1840,30 +2351,30 @@ void URULShaderLibrary::ApplyMultiParametersMaterial_RT(
             }
         }
 
-        // Create new swap texture if no swap texture is supplied
+        // Acquire pooled swap texture if no swap texture is supplied
         if (! SwapTextureRTV.IsValid())
         {
-            const uint32 FlagsMask = ~(TexCreate_RenderTargetable | TexCreate_ResolveTargetable | TexCreate_ShaderResource);
-            FRHIResourceCreateInfo CreateInfo(TargetTexture->GetClearBinding());
-            RHICreateTargetableShaderResource2D(
-                TargetTexture->GetSizeX(),
-                TargetTexture->GetSizeY(),
-                TargetTexture->GetFormat(),
-                1,
-                TargetTexture->GetFlags() & FlagsMask,
-                TexCreate_RenderTargetable,
-                false,
-                CreateInfo,
-                SwapTextureRTV,
-                SwapTextureRSV,
-                TargetTexture->GetNumSamples()
-                );
+            PooledSwapTexture.AcquireSwapTexture(TargetTexture);
+            SwapTextureRTV = PooledSwapTexture.Texture;
         }
     }
 
+    // Plan ping-pong pass parity so the last pass writes to the render target.
+    // On even draw count the first pass is written to the swap texture instead,
+    // if it does not depend on existing render target contents. Only pooled
+    // swap textures are used since material parameters may refer to a
+    // supplied swap render target.
+    const bool bStartOnSwap = (
+        bIsMultiPass &&
+        (TotalDrawCount % 2) == 0 &&
+        CanStartOnSwapTarget(DrawConfig) &&
+        PooledSwapTexture.Texture.IsValid()
+        );
+
     // Prepare render target texture and resolve target
     FTextureRHIParamRef TextureRTV = TargetTexture;
     FTextureRHIParamRef TextureRSV = RenderTargetResource->TextureRHI;
+    FTextureRHIParamRef FirstPassRTV = bStartOnSwap ? FTextureRHIParamRef(SwapTextureRTV) : TextureRTV;
     FSamplerStateRHIParamRef TextureSampler = TStaticSamplerState<SF_Bilinear,AM_Clamp,AM_Clamp,AM_Clamp>::GetRHI();
 
 	// Create default render target view
@@ -1888,49 +2399,133 @@ void URULShaderLibrary::ApplyMultiParametersMaterial_RT(
     GraphicsPSOInit.BoundShaderState.VertexShaderRHI = GETSAFERHISHADER_VERTEX(*VSShader);
     GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PSShader->GetPixelShader();
 
-    // Render pass
+    // Prebuild material uniform buffers of all distinct pass parameter states.
+    //
+    // Parameter collections are cycled and the resolved swap texture alternates
+    // every pass, so pass parameter states repeat with a period of the least
+    // common multiple of collection count and two. States are evaluated in pass
+    // order for one warm-up period and one steady period, later passes reuse
+    // the uniform buffers of the steady period.
 
-    FRHIRenderPassInfo RPInfo(TextureRTV, GetRenderTargetActions(DrawConfig));
-    TransitionRenderPassTargets(RHICmdList, RPInfo);
-    RHICmdList.BeginRenderPass(RPInfo, TEXT("RULShaderLibrary_ApplyMultiParametersMaterial"));
-    {
-        // Set graphics pipeline
+    const int32 FirstBindPassIndex = FMath::Max(ParameterCollectionStartIndex, 1);
+    const int32 PassStatePeriod = ((ParameterCollectionCount % 2) == 0) ? ParameterCollectionCount : (ParameterCollectionCount * 2);
 
-        RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
-        SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+    auto GetPassStateIndex = [&](int32 PassIndex)
+    {
+        // Passes before the first parameter bind share the initial state
+        if (PassIndex < FirstBindPassIndex)
+        {
+            return 0;
+        }
 
-        // Bind shader parameters
+        const int32 PeriodPassIndex = PassIndex - FirstBindPassIndex;
 
-        if (ParameterCollectionStartIndex <= 0)
+        if (PeriodPassIndex < PassStatePeriod)
         {
-            BindMaterialInstanceParameterCollection(*MIResource, ParameterCollections[0]);
-            MIResource->CacheUniformExpressions(false);
+            return 1 + PeriodPassIndex;
         }
+        else
+        {
+            return 1 + PassStatePeriod + (PeriodPassIndex % PassStatePeriod);
+        }
+    };
 
-        SetupMaterialParameters(RHICmdList, FeatureLevel, *VSShader, PSShader, *MIResource, *View);
-
-        // Draw primitives
+    auto BindPassParameters = [&](int32 PassIndex)
+    {
+        // Bind parameters
+        int32 ParamId = (PassIndex - ParameterCollectionStartIndex) % ParameterCollectionCount;
+        const FRULShaderMaterialParameterCollection& Parameters(ParameterCollections[ParamId]);
+        BindMaterialInstanceParameterCollection(*MIResource, Parameters);
 
-        RHICmdList.SetStreamSource(0, GetFilterShaderVB(), 0);
-        RHICmdList.DrawPrimitive(0, 2, 1);
+        // Resolve named textures, pass source is the texture drawn by the previous pass
+        const bool bSourceIsFirstPassTarget = ((PassIndex - 1) % 2) == 0;
+        int32 ResolveTextureId = (bSourceIsFirstPassTarget != bStartOnSwap) ? 0 : 1;
+        UTexture* ResolveTexture = ResolveTextures[ResolveTextureId];
+        ResolveMaterialInstanceTextureParameter(*MIResource, Parameters, TEXT("__SWAP_TEXTURE__"), ResolveTexture);
+    };
 
-        // Unbind shader parameters
-        PSShader->UnbindBuffers(RHICmdList);
-    }
-    RHICmdList.EndRenderPass();
+    FMaterialRenderContext MaterialRenderContext(MIResource, *MaterialResource, &View.Get());
+    TArray<FUniformBufferRHIRef, TInlineAllocator<16>> PassUniformBuffers;
+    bool bPassStatesWrapped = false;
 
-    // Draw multi-pass if required
-    if (bIsMultiPass)
+    for (int32 i=0; i<TotalDrawCount; ++i)
     {
-        FTextureRHIParamRef TextureRTV0 = TextureRTV;
-        FTextureRHIParamRef TextureRTV1 = SwapTextureRTV;
-
-        check(TextureRTV0 != nullptr);
-        check(TextureRTV1 != nullptr);
+        const int32 StateIndex = GetPassStateIndex(i);
 
-        for (int32 i=1; i<TotalDrawCount; ++i)
+        if (StateIndex < PassUniformBuffers.Num())
         {
-            // Render pass
+            // All distinct states have been built once the steady period wraps
+            if (StateIndex > 0)
+            {
+                bPassStatesWrapped = true;
+                break;
+            }
+
+            continue;
+        }
+
+        if (i == 0)
+        {
+            if (ParameterCollectionStartIndex <= 0)
+            {
+                BindMaterialInstanceParameterCollection(*MIResource, ParameterCollections[0]);
+            }
+        }
+        else
+        {
+            BindPassParameters(i);
+        }
+
+        FUniformExpressionCache UniformExpressionCache;
+        MIResource->EvaluateUniformExpressions(UniformExpressionCache, MaterialRenderContext);
+        PassUniformBuffers.Emplace(UniformExpressionCache.UniformBuffer);
+    }
+
+    // Validate the proxy uniform expression cache so material parameter setup
+    // skips expression evaluation, pass uniform buffers are swapped into the cache
+
+    FUniformExpressionCache& ProxyUniformExpressionCache(MIResource->UniformExpressionCache[FeatureLevel]);
+    MIResource->EvaluateUniformExpressions(ProxyUniformExpressionCache, MaterialRenderContext);
+    FUniformBufferRHIRef ProxyUniformBuffer = ProxyUniformExpressionCache.UniformBuffer;
+
+    // Render pass
+
+    FRHIRenderPassInfo RPInfo(FirstPassRTV, GetRenderTargetActions(DrawConfig));
+    TransitionRenderPassTargets(RHICmdList, RPInfo);
+    RHICmdList.BeginRenderPass(RPInfo, TEXT("RULShaderLibrary_ApplyMultiParametersMaterial"));
+    {
+        // Set graphics pipeline
+
+        RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+        SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+
+        // Bind shader parameters
+
+        ProxyUniformExpressionCache.UniformBuffer = PassUniformBuffers[0];
+        SetupMaterialParameters(RHICmdList, FeatureLevel, *VSShader, PSShader, *MIResource, *View);
+
+        // Draw primitives
+
+        RHICmdList.SetStreamSource(0, GetFilterShaderVB(), 0);
+        RHICmdList.DrawPrimitive(0, 2, 1);
+
+        // Unbind shader parameters
+        PSShader->UnbindBuffers(RHICmdList);
+    }
+    RHICmdList.EndRenderPass();
+
+    // Draw multi-pass if required
+    if (bIsMultiPass)
+    {
+        FTextureRHIParamRef TextureRTV0 = FirstPassRTV;
+        FTextureRHIParamRef TextureRTV1 = bStartOnSwap ? TextureRTV : FTextureRHIParamRef(SwapTextureRTV);
+
+        check(TextureRTV0 != nullptr);
+        check(TextureRTV1 != nullptr);
+
+        for (int32 i=1; i<TotalDrawCount; ++i)
+        {
+            // Render pass
             FRHIRenderPassInfo SwapRPInfo(TextureRTV1, ERenderTargetActions::Load_Store);
             // Apply render pass target transition only on the first iteration
             if (i == 1)
@@ -1943,17 +2538,7 @@ void URULShaderLibrary::ApplyMultiParametersMaterial_RT(
 
                 if (i >= ParameterCollectionStartIndex)
                 {
-                    // Bind parameters
-                    int32 ParamId = (i - ParameterCollectionStartIndex) % ParameterCollectionCount;
-                    const FRULShaderMaterialParameterCollection& Parameters(ParameterCollections[ParamId]);
-                    BindMaterialInstanceParameterCollection(*MIResource, Parameters);
-
-                    // Resolve named textures
-                    int32 ResolveTextureId = (TextureRTV0 == TargetTexture) ? 0 : 1;
-                    UTexture* ResolveTexture = ResolveTextures[ResolveTextureId];
-                    ResolveMaterialInstanceTextureParameter(*MIResource, Parameters, TEXT("__SWAP_TEXTURE__"), ResolveTexture);
-
-                    MIResource->CacheUniformExpressions(false);
+                    ProxyUniformExpressionCache.UniformBuffer = PassUniformBuffers[GetPassStateIndex(i)];
                     SetupMaterialParameters(RHICmdList, FeatureLevel, *VSShader, PSShader, *MIResource, *View);
                 }
 
@@ -1972,14 +2557,19 @@ void URULShaderLibrary::ApplyMultiParametersMaterial_RT(
         // Unbind vertex shader parameters
         VSShader->UnbindBuffers(RHICmdList);
 
-        // Copy final drawn texture to resolve target
-        RHICmdList.CopyToResolveTarget(
-            TextureRTV0,
-            TextureRSV,
-            FResolveParams()
-            );
+        // Copy final drawn texture to resolve target if the last pass
+        // did not write to the render target or a resolve is required
+        if (TextureRTV0 != TextureRSV)
+        {
+            RHICmdList.CopyToResolveTarget(
+                TextureRTV0,
+                TextureRSV,
+                FResolveParams()
+                );
+        }
     }
     else
+    if (TextureRTV != TextureRSV)
     {
         // Copy to resolve target
         RHICmdList.CopyToResolveTarget(
@@ -1988,6 +2578,22 @@ void URULShaderLibrary::ApplyMultiParametersMaterial_RT(
             FResolveParams()
             );
     }
+
+    // Restore proxy uniform buffer and leave the material instance with the
+    // parameters of the last pass. If state evaluation stopped early, the last
+    // full period of passes determines the final parameter values.
+
+    ProxyUniformExpressionCache.UniformBuffer = ProxyUniformBuffer;
+
+    if (bPassStatesWrapped)
+    {
+        for (int32 i=TotalDrawCount-PassStatePeriod; i<TotalDrawCount; ++i)
+        {
+            BindPassParameters(i);
+        }
+    }
+
+    MIResource->CacheUniformExpressions(false);
 }
 
 void URULShaderLibrary::DrawMaterialQuad(
@@ -2111,12 +2717,12 @@ void URULShaderLibrary::DrawMaterialQuad_RT(
     MaterialRenderProxy->UpdateUniformExpressionCacheIfNeeded(FeatureLevel);
     FMaterialRenderProxy::UpdateDeferredCachedUniformExpressions();
 
-    // Create quad data SRV
+    // Upload quad data
 
     const int32 QuadCount = Quads.Num();
 
-    TResourceArray<FVector4, VERTEXBUFFER_ALIGNMENT> QuadGeomArr;
-    TResourceArray<FVector4, VERTEXBUFFER_ALIGNMENT> QuadTransformArr;
+    TArray<FVector4> QuadGeomArr;
+    TArray<FVector4> QuadTransformArr;
 
     QuadGeomArr.Reserve(QuadCount);
     QuadTransformArr.Reserve(QuadCount);
@@ -2129,27 +2735,18 @@ void URULShaderLibrary::DrawMaterialQuad_RT(
         QuadGeomArr.Emplace(Origin.X, Origin.Y, Size.X, Size.Y);
         QuadTransformArr.Emplace(Quad.Scale, Quad.Angle, Quad.Value, 0.f);
     }
-    
-    FRULReadBuffer QuadGeomData;
-    FRULReadBuffer QuadTransformData;
 
-    QuadGeomData.Initialize(
-        QuadGeomArr.GetTypeSize(),
-        QuadCount,
-        PF_A32B32G32R32F,
-        &QuadGeomArr,
-        BUF_Static,
-        TEXT("QuadGeomData")
-        );
+    FRULRHIUploadHeap& UploadHeap(FRULRHIUploadHeap::Get());
 
-    QuadTransformData.Initialize(
-        QuadTransformArr.GetTypeSize(),
-        QuadCount,
-        PF_A32B32G32R32F,
-        &QuadTransformArr,
-        BUF_Static,
-        TEXT("QuadTransformData")
-        );
+    FShaderResourceViewRHIRef QuadGeomSRV;
+    FShaderResourceViewRHIRef QuadTransformSRV;
+    uint32 QuadGeomOffset;
+    uint32 QuadTransformOffset;
+
+    UploadHeap.UploadTypedData(RHICmdList, QuadGeomArr.GetData(), QuadCount, QuadGeomSRV, QuadGeomOffset);
+    UploadHeap.UploadTypedData(RHICmdList, QuadTransformArr.GetData(), QuadCount, QuadTransformSRV, QuadTransformOffset);
+
+    const FIntPoint QuadDataOffsets(QuadGeomOffset, QuadTransformOffset);
 
 	// Create default render target view
 
@@ -2188,8 +2785,9 @@ void URULShaderLibrary::DrawMaterialQuad_RT(
 
         SetupMaterialParameters(RHICmdList, FeatureLevel, *VSShader, PSShader, *MaterialRenderProxy, *View);
 
-        VSShader->BindSRV(RHICmdList, TEXT("QuadGeomData"), QuadGeomData.SRV);
-        VSShader->BindSRV(RHICmdList, TEXT("QuadTransformData"), QuadTransformData.SRV);
+        VSShader->BindSRV(RHICmdList, FRULShaderDrawQuadVS::Slot_QuadGeomData, QuadGeomSRV);
+        VSShader->BindSRV(RHICmdList, FRULShaderDrawQuadVS::Slot_QuadTransformData, QuadTransformSRV);
+        VSShader->SetParameter(RHICmdList, FRULShaderDrawQuadVS::Slot_Params_QuadDataOffsets, QuadDataOffsets);
 
         // Draw primitives
 
@@ -2245,6 +2843,15 @@ void URULShaderLibrary::DrawMaterialPoly(
         return;
     }
 
+    for (const FGULPolyGeometryInstance& Poly : Polys)
+    {
+        if (Poly.Sides > MAX_POLY_SIDES)
+        {
+            UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::DrawMaterialPoly() ABORTED, POLY SIDES (%d) EXCEEDS MAX POLY SIDES (%d)"), Poly.Sides, MAX_POLY_SIDES);
+            return;
+        }
+    }
+
     RenderTargetResource = static_cast<FTextureRenderTarget2DResource*>(RenderTarget->GameThread_GetRenderTargetResource());
 
     if (! RenderTargetResource)
@@ -2261,8 +2868,7 @@ void URULShaderLibrary::DrawMaterialPoly(
     struct FRenderParameter
     {
         ERHIFeatureLevel::Type FeatureLevel;
-        TArray<FVector4> Vertices;
-        TArray<int32> Indices;
+        TArray<FGULPolyGeometryInstance> Polys;
         FTextureRenderTarget2DResource* RenderTargetResource;
         const FMaterialRenderProxy* MaterialRenderProxy;
         FRULShaderDrawConfig DrawConfig;
@@ -2271,56 +2877,20 @@ void URULShaderLibrary::DrawMaterialPoly(
 
     FRenderParameter RenderParameter = {
         FeatureLevel,
-        {},
-        {},
+        Polys,
         RenderTargetResource,
         MaterialRenderProxy,
         DrawConfig,
         CallbackEvent
         };
 
-    for (const FGULPolyGeometryInstance& Poly : Polys)
-    {
-        const int32 Sides = FMath::Max(3, Poly.Sides);
-
-        TArray<FVector4>& Vertices(RenderParameter.Vertices);
-        TArray<int32>& Indices(RenderParameter.Indices);
-
-        const FVector2D& Origin(Poly.Origin);
-        const FVector2D& Size(Poly.Size);
-        const float Value = Poly.Value;
-        const float Scale = Poly.Scale;
-        const float UnitAngle = 2*PI / Sides;
-        int32 OriginIndex = Vertices.Num();
-        int32 IndexOffset = OriginIndex+1;
-
-        Vertices.Emplace(Origin.X, Origin.Y, Value, 1.f);
-
-        for (int32 i=0; i<Sides; ++i)
-        {
-            float ExtentS, ExtentC;
-            float AngleDeg = FMath::RadiansToDegrees(Poly.Angle);
-            FMath::SinCos(&ExtentS, &ExtentC, i*UnitAngle);
-
-            FVector2D Extent(ExtentC, ExtentS);
-            FVector2D Vertex(Origin + (Extent * Size * Scale).GetRotated(AngleDeg));
-
-            Vertices.Emplace(Vertex.X, Vertex.Y, Value, 0.f);
-
-            Indices.Emplace(OriginIndex  );
-            Indices.Emplace(IndexOffset+i);
-            Indices.Emplace(IndexOffset+(i+1)%Sides);
-        }
-    }
-
     ENQUEUE_RENDER_COMMAND(RULUtilityShaderLibrary_DrawMaterialPoly)(
         [RenderParameter](FRHICommandListImmediate& RHICmdList)
         {
             URULShaderLibrary::DrawMaterialPoly_RT(
                 RHICmdList,
                 RenderParameter.FeatureLevel,
-                RenderParameter.Vertices,
-                RenderParameter.Indices,
+                RenderParameter.Polys,
                 RenderParameter.RenderTargetResource,
                 RenderParameter.MaterialRenderProxy,
                 RenderParameter.DrawConfig
@@ -2330,6 +2900,148 @@ void URULShaderLibrary::DrawMaterialPoly(
     );
 }
 
+void URULShaderLibrary::DrawMaterialPoly_RT(
+    FRHICommandListImmediate& RHICmdList,
+    ERHIFeatureLevel::Type FeatureLevel,
+    const TArray<FGULPolyGeometryInstance>& Polys,
+    FTextureRenderTarget2DResource* RenderTargetResource,
+    const FMaterialRenderProxy* MaterialRenderProxy,
+    FRULShaderDrawConfig DrawConfig
+    )
+{
+    check(IsInRenderingThread());
+
+    const FMaterial* MaterialResource = MaterialRenderProxy->GetMaterial(FeatureLevel);
+
+    if (! RenderTargetResource || ! MaterialRenderProxy || ! MaterialResource)
+    {
+        return;
+    }
+
+    // Prepare render target texture and resolve target
+    FTextureRHIParamRef TextureRTV = RenderTargetResource->GetRenderTargetTexture();
+    FTextureRHIParamRef TextureRSV = RenderTargetResource->TextureRHI;
+
+    if (! TextureRTV || ! TextureRSV)
+    {
+        return;
+    }
+
+    const int32 PolyCount = Polys.Num();
+
+    if (PolyCount < 1)
+    {
+        return;
+    }
+
+    // Update deferred expression cache
+
+    MaterialRenderProxy->UpdateUniformExpressionCacheIfNeeded(FeatureLevel);
+    FMaterialRenderProxy::UpdateDeferredCachedUniformExpressions();
+
+    // Upload one geometry and transform record per polygon in input order
+
+    TArray<FVector4> PolyGeomArr;
+    TArray<FVector4> PolyTransformArr;
+
+    PolyGeomArr.SetNumUninitialized(PolyCount);
+    PolyTransformArr.SetNumUninitialized(PolyCount);
+
+    for (int32 i=0; i<PolyCount; ++i)
+    {
+        const FGULPolyGeometryInstance& Poly(Polys[i]);
+        const FVector2D& Origin(Poly.Origin);
+        const FVector2D& Size(Poly.Size);
+
+        PolyGeomArr[i] = FVector4(Origin.X, Origin.Y, Size.X, Size.Y);
+        PolyTransformArr[i] = FVector4(Poly.Scale, Poly.Angle, Poly.Value, 0.f);
+    }
+
+    FRULRHIUploadHeap& UploadHeap(FRULRHIUploadHeap::Get());
+
+    FShaderResourceViewRHIRef PolyGeomSRV;
+    FShaderResourceViewRHIRef PolyTransformSRV;
+    uint32 PolyGeomOffset;
+    uint32 PolyTransformOffset;
+
+    UploadHeap.UploadTypedData(RHICmdList, PolyGeomArr.GetData(), PolyCount, PolyGeomSRV, PolyGeomOffset);
+    UploadHeap.UploadTypedData(RHICmdList, PolyTransformArr.GetData(), PolyCount, PolyTransformSRV, PolyTransformOffset);
+
+	// Create default render target view
+
+	FIntRect ViewRect;
+    TSharedRef<FSceneView> View(CreateDefaultRTView(RHICmdList, RenderTargetResource, ViewRect));
+
+    // Setup viewport
+
+    RHICmdList.SetViewport(ViewRect.Min.X, ViewRect.Min.Y, 0.0f, ViewRect.Max.X, ViewRect.Max.Y, 1.0f);
+
+    // Prepare graphics pipelane
+
+    TShaderMapRef<FRULShaderDrawPolyInstanceVS> VSShader(GetGlobalShaderMap(FeatureLevel));
+
+	const FMaterialShaderMap* MaterialShaderMap = MaterialResource->GetRenderingThreadShaderMap();
+	FRULBaseMaterialShader* PSShader = MaterialShaderMap->GetShader<TRULShaderDrawScreenMS<1>>();
+
+    FGraphicsPipelineStateInitializer GraphicsPSOInit;
+    SetupDefaultGraphicsPSOInit(GraphicsPSOInit, PT_TriangleList, DrawConfig);
+    GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GRULEmptyVertexDeclaration.VertexDeclarationRHI;
+    GraphicsPSOInit.BoundShaderState.VertexShaderRHI = GETSAFERHISHADER_VERTEX(*VSShader);
+    GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PSShader->GetPixelShader();
+
+    // Render pass
+
+    FRHIRenderPassInfo RPInfo(TextureRTV, GetRenderTargetActions(DrawConfig));
+    TransitionRenderPassTargets(RHICmdList, RPInfo);
+    RHICmdList.BeginRenderPass(RPInfo, TEXT("RULShaderLibrary_DrawMaterialPoly"));
+    {
+        // Set graphics pipeline
+
+        RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+        SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+
+        // Bind shader parameters
+
+        SetupMaterialParameters(RHICmdList, FeatureLevel, *VSShader, PSShader, *MaterialRenderProxy, *View);
+
+        VSShader->BindSRV(RHICmdList, FRULShaderDrawPolyInstanceVS::Slot_PolyGeomData, PolyGeomSRV);
+        VSShader->BindSRV(RHICmdList, FRULShaderDrawPolyInstanceVS::Slot_PolyTransformData, PolyTransformSRV);
+
+        // Draw primitives, one triangle fan instance per polygon.
+        // Runs of consecutive polygons with the same side count are drawn
+        // as a single instanced draw call to preserve input draw order.
+
+        const int32 MaxSides = MAX_POLY_SIDES;
+
+        for (int32 BatchOffset=0; BatchOffset<PolyCount;)
+        {
+            const int32 Sides = FMath::Clamp(Polys[BatchOffset].Sides, 3, MaxSides);
+            int32 BatchCount = 1;
+
+            while ((BatchOffset+BatchCount) < PolyCount &&
+                FMath::Clamp(Polys[BatchOffset+BatchCount].Sides, 3, MaxSides) == Sides)
+            {
+                ++BatchCount;
+            }
+
+            const FIntPoint PolyDataOffsets(PolyGeomOffset+BatchOffset, PolyTransformOffset+BatchOffset);
+
+            VSShader->SetParameter(RHICmdList, FRULShaderDrawPolyInstanceVS::Slot_Params_PolyDataOffsets, PolyDataOffsets);
+            VSShader->SetParameter(RHICmdList, FRULShaderDrawPolyInstanceVS::Slot_Params_PolySides, static_cast<uint32>(Sides));
+
+            RHICmdList.DrawPrimitive(0, Sides, BatchCount);
+
+            BatchOffset += BatchCount;
+        }
+
+        // Unbind shader parameters
+
+        VSShader->UnbindBuffers(RHICmdList);
+        PSShader->UnbindBuffers(RHICmdList);
+    }
+    RHICmdList.EndRenderPass();
+}
+
 void URULShaderLibrary::DrawMaterialPoly_RT(
     FRHICommandListImmediate& RHICmdList,
     ERHIFeatureLevel::Type FeatureLevel,
@@ -2542,9 +3254,25 @@ void URULShaderLibrary::ApplyAutoLevels_RT(
     int32 ScanBlockCountMin = 0;
     int32 ScanBlockCountMax = 0;
 
+    // Reduce min and max in a single pass over the source texture
+
+    if (bApplyLevelMin && bApplyLevelMax)
+    {
+        ScanBlockCountMin = FRULReduceScan::ReduceTexture<FRULReduceScan::SOT_MinMax, FRULReduceScan::RM_SinglePass>(
+            RHICmdList,
+            SourceTextureRHI,
+            SumData,
+            Dimension,
+            0,
+            false,
+            BUF_Static
+            );
+        ScanBlockCountMax = ScanBlockCountMin;
+    }
+    else
     if (bApplyLevelMin)
     {
-        ScanBlockCountMin = FRULReduceScan::ReduceTexture<FRULReduceScan::SOT_Min>(
+        ScanBlockCountMin = FRULReduceScan::ReduceTexture<FRULReduceScan::SOT_Min, FRULReduceScan::RM_SinglePass>(
             RHICmdList,
             SourceTextureRHI,
             SumData,
@@ -2555,9 +3283,10 @@ void URULShaderLibrary::ApplyAutoLevels_RT(
             );
     }
 
+    else
     if (bApplyLevelMax)
     {
-        ScanBlockCountMax = FRULReduceScan::ReduceTexture<FRULReduceScan::SOT_Max>(
+        ScanBlockCountMax = FRULReduceScan::ReduceTexture<FRULReduceScan::SOT_Max, FRULReduceScan::RM_SinglePass>(
             RHICmdList,
             SourceTextureRHI,
             SumData,
@@ -2616,8 +3345,8 @@ void URULShaderLibrary::ApplyAutoLevels_RT(
 
         // Bind shader parameters
 
-        PSShader->BindTexture(RHICmdList, TEXT("SourceTexture"), SourceTextureRHI);
-        PSShader->BindSRV(RHICmdList, TEXT("AutoLevelData"), SumData.SRV);
+        PSShader->BindTexture(RHICmdList, FRULShaderAutoLevelPS::Slot_SourceTexture, SourceTextureRHI);
+        PSShader->BindSRV(RHICmdList, FRULShaderAutoLevelPS::Slot_AutoLevelData, SumData.SRV);
 
         // Draw primitives
 
@@ -2632,43 +3361,453 @@ void URULShaderLibrary::ApplyAutoLevels_RT(
     RHICmdList.EndRenderPass();
 }
 
-FRULTextureValuesRef URULShaderLibrary::GetTextureValuesByPoints(
+void URULShaderLibrary::GaussianBlur(
     UObject* WorldContextObject,
-    FRULShaderTextureParameterInput SourceTexture,
-    const FVector2D ScaleDimension,
-    const TArray<FVector2D>& Points,
+    UTexture* SourceTexture,
+    UTextureRenderTarget2D* RenderTarget,
+    float Sigma,
+    ERULShaderBlurEdgeMode EdgeMode,
     UGWTTickEvent* CallbackEvent
     )
 {
 	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
-    FRULShaderTextureParameterInputResource TextureResource(SourceTexture.GetResource_GT());
-    FRULTextureValuesRef ValuesRef;
+    FTextureRenderTarget2DResource* RenderTargetResource = nullptr;
 
     if (! IsValid(World))
     {
-        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GetTextureValuesByPoints() ABORTED, INVALID WORLD CONTEXT OBJECT"));
-        return ValuesRef;
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GaussianBlur() ABORTED, INVALID WORLD CONTEXT OBJECT"));
+        return;
     }
-
-    if (! World->Scene)
+    else
+    if (! IsValid(SourceTexture))
     {
-        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GetTextureValuesByPoints() ABORTED, INVALID WORLD SCENE"));
-        return ValuesRef;
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GaussianBlur() ABORTED, INVALID TEXTURE"));
+        return;
     }
-
-    if (Points.Num() < 1)
+    else
+    if (! IsValid(RenderTarget))
     {
-        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GetTextureValuesByPoints() ABORTED, EMPTY POINTS"));
-        return ValuesRef;
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GaussianBlur() ABORTED, INVALID RENDER TARGET"));
+        return;
     }
-
-    if (ScaleDimension.X <= 0 || ScaleDimension.Y <= 0)
+    else
+    if (! (Sigma > 0.f))
     {
-        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GetTextureValuesByPoints() ABORTED, INVALID SCALE SIZE"));
-        return ValuesRef;
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GaussianBlur() ABORTED, INVALID SIGMA"));
+        return;
     }
 
-    if (! TextureResource.HasValidResource())
+    RenderTargetResource = static_cast<FTextureRenderTarget2DResource*>(RenderTarget->GameThread_GetRenderTargetResource());
+
+    if (! RenderTargetResource)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GaussianBlur() ABORTED, INVALID RENDER TARGET TEXTURE RESOURCE"));
+        return;
+    }
+
+    struct FRenderParameter
+    {
+        FTexture* SourceTexture;
+        FTextureRenderTarget2DResource* RenderTargetResource;
+        float Sigma;
+        ERULShaderBlurEdgeMode EdgeMode;
+        UGWTTickEvent* CallbackEvent;
+    };
+
+    FRenderParameter RenderParameter = {
+        SourceTexture->Resource,
+        RenderTargetResource,
+        Sigma,
+        EdgeMode,
+        CallbackEvent
+        };
+
+    ENQUEUE_RENDER_COMMAND(RULShaderLibrary_GaussianBlur)(
+        [RenderParameter](FRHICommandListImmediate& RHICmdList)
+        {
+            URULShaderLibrary::GaussianBlur_RT(
+                RHICmdList,
+                RenderParameter.SourceTexture,
+                RenderParameter.RenderTargetResource,
+                RenderParameter.Sigma,
+                RenderParameter.EdgeMode
+                );
+            FGWTTickEventRef(RenderParameter.CallbackEvent).EnqueueCallback();
+        }
+    );
+}
+
+void URULShaderLibrary::GaussianBlur_RT(
+    FRHICommandListImmediate& RHICmdList,
+    FTexture* SourceTexture,
+    FTextureRenderTarget2DResource* RenderTargetResource,
+    float Sigma,
+    ERULShaderBlurEdgeMode EdgeMode
+    )
+{
+    check(IsInRenderingThread());
+
+    if (! SourceTexture || ! RenderTargetResource)
+    {
+        return;
+    }
+
+    FTextureRHIParamRef SourceTextureRHI = SourceTexture->TextureRHI;
+    FTexture2DRHIRef TargetTexture = RenderTargetResource->GetRenderTargetTexture();
+
+    if (! SourceTextureRHI || ! TargetTexture.IsValid())
+    {
+        return;
+    }
+
+    if (FRULTextureBlur::GaussianBlur(RHICmdList, SourceTextureRHI, TargetTexture, Sigma, EdgeMode) < 0)
+    {
+        return;
+    }
+
+    // Copy to resolve target if required
+
+    FTextureRHIParamRef TextureRSV = RenderTargetResource->TextureRHI;
+
+    if (TargetTexture != TextureRSV)
+    {
+        RHICmdList.CopyToResolveTarget(
+            TargetTexture,
+            TextureRSV,
+            FResolveParams()
+            );
+    }
+}
+
+void URULShaderLibrary::BoxBlur(
+    UObject* WorldContextObject,
+    UTexture* SourceTexture,
+    UTextureRenderTarget2D* RenderTarget,
+    int32 Radius,
+    ERULShaderBlurEdgeMode EdgeMode,
+    UGWTTickEvent* CallbackEvent
+    )
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+    FTextureRenderTarget2DResource* RenderTargetResource = nullptr;
+
+    if (! IsValid(World))
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::BoxBlur() ABORTED, INVALID WORLD CONTEXT OBJECT"));
+        return;
+    }
+    else
+    if (! IsValid(SourceTexture))
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::BoxBlur() ABORTED, INVALID TEXTURE"));
+        return;
+    }
+    else
+    if (! IsValid(RenderTarget))
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::BoxBlur() ABORTED, INVALID RENDER TARGET"));
+        return;
+    }
+    else
+    if (Radius < 1)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::BoxBlur() ABORTED, INVALID RADIUS"));
+        return;
+    }
+
+    RenderTargetResource = static_cast<FTextureRenderTarget2DResource*>(RenderTarget->GameThread_GetRenderTargetResource());
+
+    if (! RenderTargetResource)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::BoxBlur() ABORTED, INVALID RENDER TARGET TEXTURE RESOURCE"));
+        return;
+    }
+
+    struct FRenderParameter
+    {
+        FTexture* SourceTexture;
+        FTextureRenderTarget2DResource* RenderTargetResource;
+        int32 Radius;
+        ERULShaderBlurEdgeMode EdgeMode;
+        UGWTTickEvent* CallbackEvent;
+    };
+
+    FRenderParameter RenderParameter = {
+        SourceTexture->Resource,
+        RenderTargetResource,
+        Radius,
+        EdgeMode,
+        CallbackEvent
+        };
+
+    ENQUEUE_RENDER_COMMAND(RULShaderLibrary_BoxBlur)(
+        [RenderParameter](FRHICommandListImmediate& RHICmdList)
+        {
+            URULShaderLibrary::BoxBlur_RT(
+                RHICmdList,
+                RenderParameter.SourceTexture,
+                RenderParameter.RenderTargetResource,
+                RenderParameter.Radius,
+                RenderParameter.EdgeMode
+                );
+            FGWTTickEventRef(RenderParameter.CallbackEvent).EnqueueCallback();
+        }
+    );
+}
+
+void URULShaderLibrary::BoxBlur_RT(
+    FRHICommandListImmediate& RHICmdList,
+    FTexture* SourceTexture,
+    FTextureRenderTarget2DResource* RenderTargetResource,
+    int32 Radius,
+    ERULShaderBlurEdgeMode EdgeMode
+    )
+{
+    check(IsInRenderingThread());
+
+    if (! SourceTexture || ! RenderTargetResource)
+    {
+        return;
+    }
+
+    FTextureRHIParamRef SourceTextureRHI = SourceTexture->TextureRHI;
+    FTexture2DRHIRef TargetTexture = RenderTargetResource->GetRenderTargetTexture();
+
+    if (! SourceTextureRHI || ! TargetTexture.IsValid())
+    {
+        return;
+    }
+
+    if (FRULTextureBlur::BoxBlur(RHICmdList, SourceTextureRHI, TargetTexture, Radius, EdgeMode) < 0)
+    {
+        return;
+    }
+
+    // Copy to resolve target if required
+
+    FTextureRHIParamRef TextureRSV = RenderTargetResource->TextureRHI;
+
+    if (TargetTexture != TextureRSV)
+    {
+        RHICmdList.CopyToResolveTarget(
+            TargetTexture,
+            TextureRSV,
+            FResolveParams()
+            );
+    }
+}
+
+void URULShaderLibrary::ApplyHeightMapErosion(
+    UObject* WorldContextObject,
+    UTextureRenderTarget2D* HeightMap,
+    int32 IterationCount,
+    FRULShaderErosionConfig Config,
+    bool bResetSimulation,
+    UTextureRenderTarget2D* FlowMagnitudeTarget,
+    UGWTTickEvent* CallbackEvent
+    )
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+    FTextureRenderTarget2DResource* HeightMapResource = nullptr;
+    FTextureRenderTarget2DResource* FlowMagnitudeResource = nullptr;
+
+    if (! IsValid(World))
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::ApplyHeightMapErosion() ABORTED, INVALID WORLD CONTEXT OBJECT"));
+        return;
+    }
+    else
+    if (! IsValid(HeightMap))
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::ApplyHeightMapErosion() ABORTED, INVALID HEIGHT MAP"));
+        return;
+    }
+    else
+    if (HeightMap->RenderTargetFormat != RTF_R32f)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::ApplyHeightMapErosion() ABORTED, HEIGHT MAP FORMAT MUST BE RTF_R32f"));
+        return;
+    }
+    else
+    if (! FRULHeightMapErosion::IsValidDimension(FIntPoint(HeightMap->SizeX, HeightMap->SizeY)))
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::ApplyHeightMapErosion() ABORTED, INVALID HEIGHT MAP DIMENSION"));
+        return;
+    }
+    else
+    if (IterationCount < 1)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::ApplyHeightMapErosion() ABORTED, INVALID ITERATION COUNT"));
+        return;
+    }
+    else
+    if (IsValid(FlowMagnitudeTarget) && (
+        FlowMagnitudeTarget->RenderTargetFormat != RTF_R32f ||
+        FlowMagnitudeTarget->SizeX != HeightMap->SizeX ||
+        FlowMagnitudeTarget->SizeY != HeightMap->SizeY
+        ) )
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::ApplyHeightMapErosion() ABORTED, FLOW MAGNITUDE TARGET MUST BE AN RTF_R32f RENDER TARGET OF THE HEIGHT MAP DIMENSION"));
+        return;
+    }
+
+    HeightMapResource = static_cast<FTextureRenderTarget2DResource*>(HeightMap->GameThread_GetRenderTargetResource());
+
+    if (! HeightMapResource)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::ApplyHeightMapErosion() ABORTED, INVALID HEIGHT MAP TEXTURE RESOURCE"));
+        return;
+    }
+
+    if (IsValid(FlowMagnitudeTarget))
+    {
+        FlowMagnitudeResource = static_cast<FTextureRenderTarget2DResource*>(FlowMagnitudeTarget->GameThread_GetRenderTargetResource());
+    }
+
+    struct FRenderParameter
+    {
+        FTextureRenderTarget2DResource* HeightMapResource;
+        FTextureRenderTarget2DResource* FlowMagnitudeResource;
+        int32 IterationCount;
+        FRULShaderErosionConfig Config;
+        bool bResetSimulation;
+        UGWTTickEvent* CallbackEvent;
+    };
+
+    FRenderParameter RenderParameter = {
+        HeightMapResource,
+        FlowMagnitudeResource,
+        IterationCount,
+        Config,
+        bResetSimulation,
+        CallbackEvent
+        };
+
+    ENQUEUE_RENDER_COMMAND(RULShaderLibrary_ApplyHeightMapErosion)(
+        [RenderParameter](FRHICommandListImmediate& RHICmdList)
+        {
+            URULShaderLibrary::ApplyHeightMapErosion_RT(
+                RHICmdList,
+                RenderParameter.HeightMapResource,
+                RenderParameter.IterationCount,
+                RenderParameter.Config,
+                RenderParameter.bResetSimulation,
+                RenderParameter.FlowMagnitudeResource
+                );
+            FGWTTickEventRef(RenderParameter.CallbackEvent).EnqueueCallback();
+        }
+    );
+}
+
+void URULShaderLibrary::ApplyHeightMapErosion_RT(
+    FRHICommandListImmediate& RHICmdList,
+    FTextureRenderTarget2DResource* HeightMapResource,
+    int32 IterationCount,
+    const FRULShaderErosionConfig& Config,
+    bool bResetSimulation,
+    FTextureRenderTarget2DResource* FlowMagnitudeResource
+    )
+{
+    check(IsInRenderingThread());
+
+    if (! HeightMapResource)
+    {
+        return;
+    }
+
+    FTexture2DRHIRef HeightTexture = HeightMapResource->GetRenderTargetTexture();
+
+    if (! HeightTexture.IsValid())
+    {
+        return;
+    }
+
+    FRULHeightMapErosion& Erosion(FRULHeightMapErosion::Get());
+    const FIntPoint Dimension(HeightTexture->GetSizeX(), HeightTexture->GetSizeY());
+
+    // Simulation state of a different dimension is reset on initialization
+    if (bResetSimulation && Erosion.GetDimension() == Dimension)
+    {
+        Erosion.ResetState(RHICmdList);
+    }
+
+    if (Erosion.Simulate(RHICmdList, HeightTexture, IterationCount, Config) < 0)
+    {
+        return;
+    }
+
+    // Copy to resolve target if required
+
+    FTextureRHIParamRef TextureRSV = HeightMapResource->TextureRHI;
+
+    if (HeightTexture != TextureRSV)
+    {
+        RHICmdList.CopyToResolveTarget(
+            HeightTexture,
+            TextureRSV,
+            FResolveParams()
+            );
+    }
+
+    // Write flow magnitude
+
+    FTexture2DRHIRef FlowTexture = FlowMagnitudeResource
+        ? FlowMagnitudeResource->GetRenderTargetTexture()
+        : FTexture2DRHIRef();
+
+    if (FlowTexture.IsValid() && Erosion.WriteFlowMagnitude(RHICmdList, FlowTexture))
+    {
+        FTextureRHIParamRef FlowTextureRSV = FlowMagnitudeResource->TextureRHI;
+
+        if (FlowTexture != FlowTextureRSV)
+        {
+            RHICmdList.CopyToResolveTarget(
+                FlowTexture,
+                FlowTextureRSV,
+                FResolveParams()
+                );
+        }
+    }
+}
+
+FRULTextureValuesRef URULShaderLibrary::GetTextureValuesByPoints(
+    UObject* WorldContextObject,
+    FRULShaderTextureParameterInput SourceTexture,
+    const FVector2D ScaleDimension,
+    const TArray<FVector2D>& Points,
+    UGWTTickEvent* CallbackEvent,
+    bool bAsyncReadback
+    )
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+    FRULShaderTextureParameterInputResource TextureResource(SourceTexture.GetResource_GT());
+    FRULTextureValuesRef ValuesRef;
+
+    if (! IsValid(World))
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GetTextureValuesByPoints() ABORTED, INVALID WORLD CONTEXT OBJECT"));
+        return ValuesRef;
+    }
+
+    if (! World->Scene)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GetTextureValuesByPoints() ABORTED, INVALID WORLD SCENE"));
+        return ValuesRef;
+    }
+
+    if (Points.Num() < 1)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GetTextureValuesByPoints() ABORTED, EMPTY POINTS"));
+        return ValuesRef;
+    }
+
+    if (ScaleDimension.X <= 0 || ScaleDimension.Y <= 0)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GetTextureValuesByPoints() ABORTED, INVALID SCALE SIZE"));
+        return ValuesRef;
+    }
+
+    if (! TextureResource.HasValidResource())
     {
         UE_LOG(LogRUL,Warning, TEXT("URULShaderLibrary::GetTextureValuesByPoints() ABORTED, INVALID TEXTURE INPUT"));
         return ValuesRef;
@@ -2684,6 +3823,7 @@ FRULTextureValuesRef URULShaderLibrary::GetTextureValuesByPoints(
         FVector2D ScaleDimension;
         const TArray<FVector2D> Points;
         FRULTextureValuesRef::FSharedRefType ValuesRef;
+        bool bAsyncReadback;
         UGWTTickEvent* CallbackEvent;
     };
 
@@ -2693,6 +3833,7 @@ FRULTextureValuesRef URULShaderLibrary::GetTextureValuesByPoints(
         ScaleDimension,
         Points,
         ValuesRef.SharedRef,
+        bAsyncReadback,
         CallbackEvent
         };
 
@@ -2701,40 +3842,159 @@ FRULTextureValuesRef URULShaderLibrary::GetTextureValuesByPoints(
     ENQUEUE_RENDER_COMMAND(RULUtilityShaderLibrary_GetTextureValuesByPoints)(
         [RenderParameter](FRHICommandListImmediate& RHICmdList)
         {
-            URULShaderLibrary::GetTextureValuesByPoints_RT(
-                RHICmdList,
-                RenderParameter.FeatureLevel,
-                RenderParameter.TextureResource,
-                RenderParameter.ScaleDimension,
-                RenderParameter.Points,
-                RenderParameter.ValuesRef
-                );
-            FGWTTickEventRef(RenderParameter.CallbackEvent).EnqueueCallback();
+            if (RenderParameter.bAsyncReadback)
+            {
+                // Callback is fired once the readback completes
+                URULShaderLibrary::GetTextureValuesByPointsAsync_RT(
+                    RHICmdList,
+                    RenderParameter.FeatureLevel,
+                    RenderParameter.TextureResource,
+                    RenderParameter.ScaleDimension,
+                    RenderParameter.Points,
+                    RenderParameter.ValuesRef,
+                    RenderParameter.CallbackEvent
+                    );
+            }
+            else
+            {
+                URULShaderLibrary::GetTextureValuesByPoints_RT(
+                    RHICmdList,
+                    RenderParameter.FeatureLevel,
+                    RenderParameter.TextureResource,
+                    RenderParameter.ScaleDimension,
+                    RenderParameter.Points,
+                    RenderParameter.ValuesRef
+                    );
+                FGWTTickEventRef(RenderParameter.CallbackEvent).EnqueueCallback();
+            }
         }
     );
 
     return ValuesRef;
 }
 
-void URULShaderLibrary::GetTextureValuesByPoints_RT(
+// Pending asynchronous texture value readbacks, polled on the render thread
+// until the copy fence of each readback is signaled. Pending readbacks are
+// dropped when the RHI resources are released.
+
+class FRULTextureValuesReadbackQueue : public FRenderResource, public FTickableObjectRenderThread
+{
+public:
+
+    struct FPendingReadback
+    {
+        TSharedPtr<FRHIGPUBufferReadback> Readback;
+        FRULTextureValuesRef::FSharedRefType ValuesRef;
+        int32 PointCount;
+        UGWTTickEvent* CallbackEvent;
+    };
+
+    FRULTextureValuesReadbackQueue()
+        : FTickableObjectRenderThread(false, true)
+        , bRegistered(false)
+    {
+    }
+
+    void Enqueue(const FPendingReadback& PendingReadback)
+    {
+        check(IsInRenderingThread());
+
+        PendingReadbacks.Emplace(PendingReadback);
+
+        // Register on first use, ticks are skipped while there is no pending readback
+        if (! bRegistered)
+        {
+            Register();
+            bRegistered = true;
+        }
+    }
+
+    virtual void ReleaseDynamicRHI() override
+    {
+        // Staging buffers of pending readbacks are invalid past this point
+        PendingReadbacks.Empty();
+
+        if (bRegistered)
+        {
+            Unregister();
+            bRegistered = false;
+        }
+    }
+
+    virtual void Tick(float DeltaTime) override
+    {
+        check(IsInRenderingThread());
+
+        // Resolve readbacks in submission order
+
+        int32 ResolvedCount = 0;
+
+        for (; ResolvedCount<PendingReadbacks.Num(); ++ResolvedCount)
+        {
+            FPendingReadback& PendingReadback(PendingReadbacks[ResolvedCount]);
+
+            if (! PendingReadback.Readback->IsReady())
+            {
+                break;
+            }
+
+            const int32 PointCount = PendingReadback.PointCount;
+            const uint32 NumBytes = PointCount * sizeof(FLinearColor);
+
+            TArray<FLinearColor>& Values(PendingReadback.ValuesRef->Values);
+
+            // Resize output value count if required
+            if (Values.Num() != PointCount)
+            {
+                Values.SetNumUninitialized(PointCount, true);
+            }
+
+            // Copy values
+            void* ValueDataPtr = PendingReadback.Readback->Lock(NumBytes);
+            FMemory::Memcpy(Values.GetData(), ValueDataPtr, NumBytes);
+            PendingReadback.Readback->Unlock();
+
+            FGWTTickEventRef(PendingReadback.CallbackEvent).EnqueueCallback();
+        }
+
+        if (ResolvedCount > 0)
+        {
+            PendingReadbacks.RemoveAt(0, ResolvedCount, false);
+        }
+    }
+
+    virtual bool IsTickable() const override
+    {
+        return PendingReadbacks.Num() > 0;
+    }
+
+    virtual TStatId GetStatId() const override
+    {
+        RETURN_QUICK_DECLARE_CYCLE_STAT(FRULTextureValuesReadbackQueue, STATGROUP_Tickables);
+    }
+
+private:
+
+    TArray<FPendingReadback> PendingReadbacks;
+    bool bRegistered;
+};
+
+TGlobalResource<FRULTextureValuesReadbackQueue> GRULTextureValuesReadbackQueue;
+
+static bool DispatchGetTextureValuesByPoints(
     FRHICommandListImmediate& RHICmdList,
     ERHIFeatureLevel::Type FeatureLevel,
-    FRULShaderTextureParameterInputResource TextureResource,
+    FRULShaderTextureParameterInputResource& TextureResource,
     const FVector2D ScaleDimension,
     const TArray<FVector2D>& Points,
-    FRULTextureValuesRef::FSharedRefType ValuesRef
+    FRULRWBuffer& ValueData
     )
 {
-    check(IsInRenderingThread());
-    check(ScaleDimension.X > 0.f);
-    check(ScaleDimension.Y > 0.f);
-    check(ValuesRef.IsValid());
-
     FTexture2DRHIParamRef SourceTexture = TextureResource.GetTextureParamRef_RT();
 
     if (! SourceTexture)
     {
-        return;
+        return false;
     }
 
     const FVector2D PointScale = FVector2D::UnitVector / ScaleDimension;
@@ -2759,10 +4019,12 @@ void URULShaderLibrary::GetTextureValuesByPoints_RT(
         TEXT("PointData")
         );
     
-    FRULRWBufferStructured ValueData;
+    // Value data is a typed vertex buffer so it could be copied to a staging buffer
+
     ValueData.Initialize(
         sizeof(FLinearColor),
         PointCount,
+        PF_A32B32G32R32F,
         BUF_Static,
         TEXT("ValueData")
         );
@@ -2773,34 +4035,99 @@ void URULShaderLibrary::GetTextureValuesByPoints_RT(
 
         TShaderMapRef<FRULShaderGetTextureValues> ComputeShader(GetGlobalShaderMap(FeatureLevel));
         ComputeShader->SetShader(RHICmdList);
-        ComputeShader->BindTexture(RHICmdList, TEXT("SourceTexture"), TEXT("SourceTextureSampler"), SourceTexture, TextureSampler);
-        ComputeShader->BindSRV(RHICmdList, TEXT("PointData"), PointData.SRV);
-        ComputeShader->BindUAV(RHICmdList, TEXT("OutValueData"), ValueData.UAV);
-        ComputeShader->SetParameter(RHICmdList, TEXT("_PointScale"), PointScale);
-        ComputeShader->SetParameter(RHICmdList, TEXT("_PointCount"), PointCount);
+        ComputeShader->BindTexture(RHICmdList, FRULShaderGetTextureValues::Slot_SourceTexture, FRULShaderGetTextureValues::Slot_SourceTextureSampler, SourceTexture, TextureSampler);
+        ComputeShader->BindSRV(RHICmdList, FRULShaderGetTextureValues::Slot_PointData, PointData.SRV);
+        ComputeShader->BindUAV(RHICmdList, FRULShaderGetTextureValues::Slot_OutValueData, ValueData.UAV);
+        ComputeShader->SetParameter(RHICmdList, FRULShaderGetTextureValues::Slot_Params_PointScale, PointScale);
+        ComputeShader->SetParameter(RHICmdList, FRULShaderGetTextureValues::Slot_Params_PointCount, PointCount);
         ComputeShader->DispatchAndClear(RHICmdList, PointCount, 1, 1);
+    }
+    RHICmdList.EndComputePass();
 
-        TArray<FLinearColor>& Values(ValuesRef->Values);
+    return true;
+}
 
-        // Resize output value count if required
-        if (Values.Num() != PointCount)
-        {
-            Values.SetNumUninitialized(PointCount, true);
-        }
+void URULShaderLibrary::GetTextureValuesByPoints_RT(
+    FRHICommandListImmediate& RHICmdList,
+    ERHIFeatureLevel::Type FeatureLevel,
+    FRULShaderTextureParameterInputResource TextureResource,
+    const FVector2D ScaleDimension,
+    const TArray<FVector2D>& Points,
+    FRULTextureValuesRef::FSharedRefType ValuesRef
+    )
+{
+    check(IsInRenderingThread());
+    check(ScaleDimension.X > 0.f);
+    check(ScaleDimension.Y > 0.f);
+    check(ValuesRef.IsValid());
 
-        // Copy values
-        void* ValueDataPtr = RHILockStructuredBuffer(ValueData.Buffer, 0, ValueData.Buffer->GetSize(), RLM_ReadOnly);
-        FMemory::Memcpy(Values.GetData(), ValueDataPtr, ValueData.Buffer->GetSize());
-        RHIUnlockStructuredBuffer(ValueData.Buffer);
+    FRULRWBuffer ValueData;
+
+    if (! DispatchGetTextureValuesByPoints(RHICmdList, FeatureLevel, TextureResource, ScaleDimension, Points, ValueData))
+    {
+        return;
+    }
+
+    const int32 PointCount = Points.Num();
+
+    TArray<FLinearColor>& Values(ValuesRef->Values);
+
+    // Resize output value count if required
+    if (Values.Num() != PointCount)
+    {
+        Values.SetNumUninitialized(PointCount, true);
+    }
+
+    // Copy values, blocks until the dispatch completes
+    void* ValueDataPtr = ValueData.LockReadOnly();
+    FMemory::Memcpy(Values.GetData(), ValueDataPtr, ValueData.NumBytes);
+    ValueData.Unlock();
 
 #if 0
-        for (int32 i=0; i<PointCount; ++i)
-        {
-            UE_LOG(LogTemp,Warning, TEXT("Values[%d]: %s"), i, *Values[i].ToString());
-        }
+    for (int32 i=0; i<PointCount; ++i)
+    {
+        UE_LOG(LogTemp,Warning, TEXT("Values[%d]: %s"), i, *Values[i].ToString());
+    }
 #endif
+}
+
+void URULShaderLibrary::GetTextureValuesByPointsAsync_RT(
+    FRHICommandListImmediate& RHICmdList,
+    ERHIFeatureLevel::Type FeatureLevel,
+    FRULShaderTextureParameterInputResource TextureResource,
+    const FVector2D ScaleDimension,
+    const TArray<FVector2D>& Points,
+    FRULTextureValuesRef::FSharedRefType ValuesRef,
+    UGWTTickEvent* CallbackEvent
+    )
+{
+    check(IsInRenderingThread());
+    check(ScaleDimension.X > 0.f);
+    check(ScaleDimension.Y > 0.f);
+    check(ValuesRef.IsValid());
+
+    FRULRWBuffer ValueData;
+
+    if (! DispatchGetTextureValuesByPoints(RHICmdList, FeatureLevel, TextureResource, ScaleDimension, Points, ValueData))
+    {
+        FGWTTickEventRef(CallbackEvent).EnqueueCallback();
+        return;
     }
-    RHICmdList.EndComputePass();
+
+    // Copy values to a staging buffer, the readback queue fills the values
+    // and fires the callback once the copy fence is signaled
+
+    TSharedPtr<FRHIGPUBufferReadback> Readback(new FRHIGPUBufferReadback(TEXT("RULTextureValuesReadback")));
+    Readback->EnqueueCopy(RHICmdList, ValueData.Buffer);
+
+    FRULTextureValuesReadbackQueue::FPendingReadback PendingReadback = {
+        Readback,
+        ValuesRef,
+        Points.Num(),
+        CallbackEvent
+        };
+
+    GRULTextureValuesReadbackQueue.Enqueue(PendingReadback);
 }
 
 void URULShaderLibrary::GetTextureValuesOutput(const FRULTextureValuesRef& ValuesRef, TArray<FLinearColor>& Values)
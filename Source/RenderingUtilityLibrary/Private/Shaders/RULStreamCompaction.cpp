@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "Shaders/RULStreamCompaction.h"
+
+#include "ShaderParameters.h"
+#include "ShaderCore.h"
+
+#include "Shaders/RULPrefixSumScan.h"
+#include "Shaders/RULShaderDefinitions.h"
+
+template<uint32 DataDimension>
+class FRULStreamCompactionScatterCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULStreamCompactionScatterCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+        OutEnvironment.SetDefine(TEXT("data_t"), *FRULPrefixSumScan::GetScanDataTypeName<DataDimension>());
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULStreamCompactionScatterCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_3(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "SrcData",    SrcData,
+        "FlagData",   FlagData,
+        "OffsetData", OffsetData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "DstData", DstData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_ElementCount",  Params_ElementCount,
+        "_DispatchWidth", Params_DispatchWidth
+        )
+};
+
+class FRULStreamCompactionWriteIndirectArgsCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULStreamCompactionWriteIndirectArgsCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULStreamCompactionWriteIndirectArgsCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "SumData", SumData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "IndirectArgs", IndirectArgs
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_ScanBlockCount",      Params_ScanBlockCount,
+        "_IndirectThreadCount", Params_IndirectThreadCount
+        )
+};
+
+#define SHADER_FILENAME "/Plugin/RenderingUtilityLibrary/Private/RULStreamCompactionCS.usf"
+
+IMPLEMENT_SHADER_TYPE(template<>, FRULStreamCompactionScatterCS<1>, TEXT(SHADER_FILENAME), TEXT("ScatterKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FRULStreamCompactionScatterCS<2>, TEXT(SHADER_FILENAME), TEXT("ScatterKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(template<>, FRULStreamCompactionScatterCS<4>, TEXT(SHADER_FILENAME), TEXT("ScatterKernel"), SF_Compute);
+IMPLEMENT_SHADER_TYPE(, FRULStreamCompactionWriteIndirectArgsCS, TEXT(SHADER_FILENAME), TEXT("WriteIndirectArgsKernel"), SF_Compute);
+
+#undef SHADER_FILENAME
+
+template<uint32 DataDimension>
+static void DispatchStreamCompactionScatter(
+    FRHICommandListImmediate& RHICmdList,
+    FShaderResourceViewRHIParamRef SrcDataSRV,
+    FShaderResourceViewRHIParamRef FlagDataSRV,
+    FShaderResourceViewRHIParamRef OffsetDataSRV,
+    FUnorderedAccessViewRHIParamRef DstDataUAV,
+    int32 ElementCount
+    )
+{
+    typedef FRULStreamCompactionScatterCS<DataDimension> FScatterCS;
+
+    const int32 GroupCount = FMath::DivideAndRoundUp(ElementCount, FRULStreamCompaction::BLOCK_SIZE);
+    const FIntPoint DispatchCount = FScatterCS::GetLinearDispatchCount(GroupCount);
+
+    RHICmdList.BeginComputePass(TEXT("RULStreamCompactionScatter"));
+    TShaderMapRef<FScatterCS> ScatterCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+    ScatterCS->SetShader(RHICmdList);
+    ScatterCS->BindSRV(RHICmdList, FScatterCS::Slot_SrcData, SrcDataSRV);
+    ScatterCS->BindSRV(RHICmdList, FScatterCS::Slot_FlagData, FlagDataSRV);
+    ScatterCS->BindSRV(RHICmdList, FScatterCS::Slot_OffsetData, OffsetDataSRV);
+    ScatterCS->BindUAV(RHICmdList, FScatterCS::Slot_DstData, DstDataUAV);
+    ScatterCS->SetParameter(RHICmdList, FScatterCS::Slot_Params_ElementCount, ElementCount);
+    ScatterCS->SetParameter(RHICmdList, FScatterCS::Slot_Params_DispatchWidth, DispatchCount.X);
+    DispatchComputeShader(RHICmdList, *ScatterCS, DispatchCount.X, DispatchCount.Y, 1);
+    ScatterCS->UnbindBuffers(RHICmdList);
+    RHICmdList.EndComputePass();
+}
+
+int32 FRULStreamCompaction::Compact(
+    FRHICommandListImmediate& RHICmdList,
+    FShaderResourceViewRHIParamRef SrcDataSRV,
+    FShaderResourceViewRHIParamRef FlagDataSRV,
+    int32 DataStride,
+    int32 ElementCount,
+    FRULRWBufferStructured& OutputBuffer,
+    FRULRWBuffer& IndirectArgsBuffer,
+    FRULRWBufferStructured& OffsetBuffer,
+    FRULRWBufferStructured& SumBuffer,
+    int32 IndirectThreadCount,
+    uint32 AdditionalOutputUsage
+    )
+{
+    check(IsInRenderingThread());
+
+    if (! SrcDataSRV || ! FlagDataSRV || ElementCount < 1)
+    {
+        return -1;
+    }
+
+    if (! IsValidDataStride(DataStride))
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULStreamCompaction::Compact() Unsupported data stride (%d)"), DataStride);
+        return -1;
+    }
+
+    IndirectThreadCount = FMath::Max(1, IndirectThreadCount);
+
+    // Exclusive scan flags into output offsets, the survivor count
+    // is written into SumBuffer at the returned scan block count
+
+    const int32 ScanBlockCount = FRULPrefixSumScan::ExclusiveScan<FRULPrefixSumScan::SDT_UINT1>(
+        RHICmdList,
+        FlagDataSRV,
+        sizeof(uint32),
+        ElementCount,
+        OffsetBuffer,
+        SumBuffer,
+        BUF_Static
+        );
+
+    if (ScanBlockCount < 0)
+    {
+        return -1;
+    }
+
+    // Initialize output buffers, reuse existing buffers if the layout matches
+
+    if (! OutputBuffer.HasLayout(DataStride, ElementCount, AdditionalOutputUsage))
+    {
+        OutputBuffer.Release();
+        OutputBuffer.Initialize(DataStride, ElementCount, AdditionalOutputUsage);
+    }
+
+    if (! IndirectArgsBuffer.IsValid() || IndirectArgsBuffer.NumBytes != (INDIRECT_ARGS_COUNT * sizeof(uint32)))
+    {
+        IndirectArgsBuffer.Release();
+        IndirectArgsBuffer.Initialize(sizeof(uint32), INDIRECT_ARGS_COUNT, PF_R32_UINT, BUF_Static | BUF_DrawIndirect);
+    }
+
+    // Scatter flagged elements
+
+    switch (DataStride / sizeof(uint32))
+    {
+        case 1:
+            DispatchStreamCompactionScatter<1>(RHICmdList, SrcDataSRV, FlagDataSRV, OffsetBuffer.SRV, OutputBuffer.UAV, ElementCount);
+            break;
+
+        case 2:
+            DispatchStreamCompactionScatter<2>(RHICmdList, SrcDataSRV, FlagDataSRV, OffsetBuffer.SRV, OutputBuffer.UAV, ElementCount);
+            break;
+
+        case 4:
+            DispatchStreamCompactionScatter<4>(RHICmdList, SrcDataSRV, FlagDataSRV, OffsetBuffer.SRV, OutputBuffer.UAV, ElementCount);
+            break;
+    }
+
+    // Write indirect arguments
+
+    typedef FRULStreamCompactionWriteIndirectArgsCS FWriteArgsCS;
+
+    RHICmdList.BeginComputePass(TEXT("RULStreamCompactionWriteIndirectArgs"));
+    TShaderMapRef<FWriteArgsCS> WriteArgsCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+    WriteArgsCS->SetShader(RHICmdList);
+    WriteArgsCS->BindSRV(RHICmdList, FWriteArgsCS::Slot_SumData, SumBuffer.SRV);
+    WriteArgsCS->BindUAV(RHICmdList, FWriteArgsCS::Slot_IndirectArgs, IndirectArgsBuffer.UAV);
+    WriteArgsCS->SetParameter(RHICmdList, FWriteArgsCS::Slot_Params_ScanBlockCount, ScanBlockCount);
+    WriteArgsCS->SetParameter(RHICmdList, FWriteArgsCS::Slot_Params_IndirectThreadCount, IndirectThreadCount);
+    DispatchComputeShader(RHICmdList, *WriteArgsCS, 1, 1, 1);
+    WriteArgsCS->UnbindBuffers(RHICmdList);
+    RHICmdList.EndComputePass();
+
+    return ScanBlockCount;
+}
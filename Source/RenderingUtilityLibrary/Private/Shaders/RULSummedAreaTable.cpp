@@ -0,0 +1,243 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "Shaders/RULSummedAreaTable.h"
+
+#include "ShaderParameters.h"
+#include "ShaderCore.h"
+
+#include "Shaders/RULShaderDefinitions.h"
+
+template<uint32 DataDimension, uint32 bDoubleFloat>
+class FRULSummedAreaTableRowScanCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULSummedAreaTableRowScanCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+        OutEnvironment.SetDefine(TEXT("data_t"), (DataDimension > 1) ? TEXT("float4") : TEXT("float"));
+        OutEnvironment.SetDefine(TEXT("SAT_DOUBLE_FLOAT"), bDoubleFloat);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER_WITH_TEXTURE(FRULSummedAreaTableRowScanCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        Texture,
+        FShaderResourceParameter,
+        FResourceId,
+        "SourceTexture", SourceTexture
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_0(Sampler,,)
+
+    RUL_DECLARE_SHADER_PARAMETERS_0(SRV,,)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "DstData", DstData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_Dimension",     Params_Dimension,
+        "_DispatchWidth", Params_DispatchWidth
+        )
+};
+
+template<uint32 DataDimension, uint32 bDoubleFloat>
+class FRULSummedAreaTableColumnScanCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULSummedAreaTableColumnScanCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+        OutEnvironment.SetDefine(TEXT("data_t"), (DataDimension > 1) ? TEXT("float4") : TEXT("float"));
+        OutEnvironment.SetDefine(TEXT("SAT_DOUBLE_FLOAT"), bDoubleFloat);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER(FRULSummedAreaTableColumnScanCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_0(SRV,,)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "DstData", DstData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_2(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_Dimension",     Params_Dimension,
+        "_DispatchWidth", Params_DispatchWidth
+        )
+};
+
+#define SHADER_FILENAME "/Plugin/RenderingUtilityLibrary/Private/RULSummedAreaTableCS.usf"
+#define SAT_KERNEL(N,D,DF) N<D,DF>
+
+#define IMPLEMENT_SAT_SHADER(D,DF) \
+IMPLEMENT_SHADER_TYPE(template<>, SAT_KERNEL(FRULSummedAreaTableRowScanCS,D,DF), TEXT(SHADER_FILENAME), TEXT("RowScanKernel"), SF_Compute);\
+IMPLEMENT_SHADER_TYPE(template<>, SAT_KERNEL(FRULSummedAreaTableColumnScanCS,D,DF), TEXT(SHADER_FILENAME), TEXT("ColumnScanKernel"), SF_Compute);
+
+IMPLEMENT_SAT_SHADER(1,0)
+IMPLEMENT_SAT_SHADER(1,1)
+IMPLEMENT_SAT_SHADER(4,0)
+IMPLEMENT_SAT_SHADER(4,1)
+
+#undef IMPLEMENT_SAT_SHADER
+#undef SAT_KERNEL
+#undef SHADER_FILENAME
+
+int32 FRULSummedAreaTable::Build(
+    FRHICommandListImmediate& RHICmdList,
+    FTextureRHIParamRef SourceTexture,
+    FIntPoint Dimension,
+    FRULRWBufferStructured& SATBuffer,
+    FSATDataType DataType,
+    bool bDoubleFloat,
+    uint32 AdditionalOutputUsage
+    )
+{
+    check(IsInRenderingThread());
+
+    if (! SourceTexture || Dimension.X < 1 || Dimension.Y < 1)
+    {
+        return -1;
+    }
+
+    if (DataType != SATDT_FLOAT1 && DataType != SATDT_FLOAT4)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULSummedAreaTable::Build() Invalid data type (%d)"), static_cast<int32>(DataType));
+        return -1;
+    }
+
+    const int32 EntryStride = GetEntryStride(DataType, bDoubleFloat);
+    const int32 EntryCount  = Dimension.X * Dimension.Y;
+
+    // Initialize table buffer, reuse existing buffer if the layout matches
+
+    if (! SATBuffer.HasLayout(EntryStride, EntryCount, AdditionalOutputUsage))
+    {
+        SATBuffer.Release();
+        SATBuffer.Initialize(EntryStride, EntryCount, AdditionalOutputUsage);
+    }
+
+    if (DataType == SATDT_FLOAT1)
+    {
+        if (bDoubleFloat)
+        {
+            BuildTable<1,1>(RHICmdList, SourceTexture, Dimension, SATBuffer);
+        }
+        else
+        {
+            BuildTable<1,0>(RHICmdList, SourceTexture, Dimension, SATBuffer);
+        }
+    }
+    else
+    {
+        if (bDoubleFloat)
+        {
+            BuildTable<4,1>(RHICmdList, SourceTexture, Dimension, SATBuffer);
+        }
+        else
+        {
+            BuildTable<4,0>(RHICmdList, SourceTexture, Dimension, SATBuffer);
+        }
+    }
+
+    return 0;
+}
+
+template<uint32 DataDimension, uint32 bDoubleFloat>
+void FRULSummedAreaTable::BuildTable(
+    FRHICommandListImmediate& RHICmdList,
+    FTextureRHIParamRef SourceTexture,
+    FIntPoint Dimension,
+    FRULRWBufferStructured& SATBuffer
+    )
+{
+    typedef FRULSummedAreaTableRowScanCS<DataDimension, bDoubleFloat>    FRowScanCS;
+    typedef FRULSummedAreaTableColumnScanCS<DataDimension, bDoubleFloat> FColumnScanCS;
+
+    // Row scan, one group per row
+
+    {
+        const FIntPoint DispatchCount = FRowScanCS::GetLinearDispatchCount(Dimension.Y);
+
+        RHICmdList.BeginComputePass(TEXT("RULSummedAreaTableRowScan"));
+        TShaderMapRef<FRowScanCS> RowScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        RowScanCS->SetShader(RHICmdList);
+        RowScanCS->BindTexture(RHICmdList, FRowScanCS::Slot_SourceTexture, SourceTexture);
+        RowScanCS->BindUAV(RHICmdList, FRowScanCS::Slot_DstData, SATBuffer.UAV);
+        RowScanCS->SetParameter(RHICmdList, FRowScanCS::Slot_Params_Dimension, Dimension);
+        RowScanCS->SetParameter(RHICmdList, FRowScanCS::Slot_Params_DispatchWidth, DispatchCount.X);
+        DispatchComputeShader(RHICmdList, *RowScanCS, DispatchCount.X, DispatchCount.Y, 1);
+        RowScanCS->UnbindBuffers(RHICmdList);
+        RHICmdList.EndComputePass();
+    }
+
+    // In place column scan, one thread per column
+
+    {
+        const FIntPoint DispatchCount = FColumnScanCS::GetLinearDispatchCount(FMath::DivideAndRoundUp(Dimension.X, BLOCK_SIZE));
+
+        RHICmdList.BeginComputePass(TEXT("RULSummedAreaTableColumnScan"));
+        TShaderMapRef<FColumnScanCS> ColumnScanCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+        ColumnScanCS->SetShader(RHICmdList);
+        ColumnScanCS->BindUAV(RHICmdList, FColumnScanCS::Slot_DstData, SATBuffer.UAV);
+        ColumnScanCS->SetParameter(RHICmdList, FColumnScanCS::Slot_Params_Dimension, Dimension);
+        ColumnScanCS->SetParameter(RHICmdList, FColumnScanCS::Slot_Params_DispatchWidth, DispatchCount.X);
+        DispatchComputeShader(RHICmdList, *ColumnScanCS, DispatchCount.X, DispatchCount.Y, 1);
+        ColumnScanCS->UnbindBuffers(RHICmdList);
+        RHICmdList.EndComputePass();
+    }
+}
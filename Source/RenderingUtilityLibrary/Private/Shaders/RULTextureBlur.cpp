@@ -0,0 +1,317 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// MIT License
+// 
+// Copyright (c) 2018-2019 Nuraga Wiswakarma
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+// 
+
+#include "Shaders/RULTextureBlur.h"
+
+#include "RHICommandList.h"
+#include "ShaderParameters.h"
+#include "ShaderCore.h"
+
+#include "RenderingUtilityLibrary.h"
+#include "RHI/RULRHIRenderTargetPool.h"
+#include "RHI/RULRHIUploadHeap.h"
+#include "Shaders/RULShaderDefinitions.h"
+
+class FRULTextureBlurCS : public FRULBaseComputeShader<>
+{
+    typedef FRULBaseComputeShader<> FBaseType;
+
+    DECLARE_SHADER_TYPE(FRULTextureBlurCS, Global);
+
+    static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+    {
+        return RHISupportsComputeShaders(Parameters.Platform);
+    }
+
+    static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+    {
+        FBaseType::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+        OutEnvironment.CompilerFlags.Add(CFLAG_StandardOptimization);
+    }
+
+    RUL_DECLARE_SHADER_CONSTRUCTOR_SERIALIZER_WITH_TEXTURE(FRULTextureBlurCS)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        Texture,
+        FShaderResourceParameter,
+        FResourceId,
+        "SourceTexture", SourceTexture
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_0(Sampler,,)
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        SRV,
+        FShaderResourceParameter,
+        FResourceId,
+        "WeightData", WeightData
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_1(
+        UAV,
+        FShaderResourceParameter,
+        FResourceId,
+        "OutputTexture", OutputTexture
+        )
+
+    RUL_DECLARE_SHADER_PARAMETERS_4(
+        Value,
+        FShaderParameter,
+        FParameterId,
+        "_Dimension",    Params_Dimension,
+        "_Radius",       Params_Radius,
+        "_WeightOffset", Params_WeightOffset,
+        "_EdgeMode",     Params_EdgeMode
+        )
+};
+
+#define SHADER_FILENAME "/Plugin/RenderingUtilityLibrary/Private/RULTextureBlurCS.usf"
+
+IMPLEMENT_SHADER_TYPE(, FRULTextureBlurCS, TEXT(SHADER_FILENAME), TEXT("BlurKernel"), SF_Compute);
+
+#undef SHADER_FILENAME
+
+int32 FRULTextureBlur::GaussianBlur(
+    FRHICommandListImmediate& RHICmdList,
+    FTextureRHIParamRef SourceTexture,
+    FTexture2DRHIParamRef OutputTexture,
+    float Sigma,
+    ERULShaderBlurEdgeMode EdgeMode
+    )
+{
+    check(IsInRenderingThread());
+
+    if (! (Sigma > 0.f))
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULTextureBlur::GaussianBlur() Invalid sigma (%f)"), Sigma);
+        return -1;
+    }
+
+    if (! SourceTexture || ! OutputTexture || SourceTexture->GetSizeXYZ() != OutputTexture->GetSizeXYZ())
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULTextureBlur::GaussianBlur() Source and output textures must be valid and of the same dimension"));
+        return -1;
+    }
+
+    // Split blurs exceeding max radius into passes of equal sigma,
+    // variance of repeated gaussian passes is the sum of pass variances.
+    // Pass count grows with the square of sigma, blurs past the pass count
+    // limit use truncated pass kernels instead.
+
+    const int32 MaxRadius = MAX_RADIUS;
+    const int32 MaxPassCount = MAX_PASS_COUNT;
+
+    const int32 FullRadius = GetGaussianRadius(Sigma);
+    const int32 PassCount = FMath::Clamp(FMath::CeilToInt(FMath::Square(static_cast<float>(FullRadius) / MaxRadius)), 1, MaxPassCount);
+    const float PassSigma = Sigma / FMath::Sqrt(static_cast<float>(PassCount));
+    const int32 PassRadius = FMath::Clamp(GetGaussianRadius(PassSigma), 1, MaxRadius);
+
+    // Generate normalized half kernel weights
+
+    TArray<float> Weights;
+    Weights.SetNumUninitialized(PassRadius+1);
+
+    const float InvSigmaSq2 = 1.f / (2.f * PassSigma * PassSigma);
+    float WeightSum = 0.f;
+
+    for (int32 i=0; i<=PassRadius; ++i)
+    {
+        Weights[i] = FMath::Exp(-(i*i) * InvSigmaSq2);
+        WeightSum += (i > 0) ? (2.f * Weights[i]) : Weights[i];
+    }
+
+    for (float& Weight : Weights)
+    {
+        Weight /= WeightSum;
+    }
+
+    Blur(RHICmdList, SourceTexture, OutputTexture, Weights, EdgeMode, PassCount);
+
+    return PassCount;
+}
+
+int32 FRULTextureBlur::BoxBlur(
+    FRHICommandListImmediate& RHICmdList,
+    FTextureRHIParamRef SourceTexture,
+    FTexture2DRHIParamRef OutputTexture,
+    int32 Radius,
+    ERULShaderBlurEdgeMode EdgeMode
+    )
+{
+    check(IsInRenderingThread());
+
+    if (Radius < 1)
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULTextureBlur::BoxBlur() Invalid radius (%d)"), Radius);
+        return -1;
+    }
+
+    if (! SourceTexture || ! OutputTexture || SourceTexture->GetSizeXYZ() != OutputTexture->GetSizeXYZ())
+    {
+        UE_LOG(LogRUL,Error, TEXT("FRULTextureBlur::BoxBlur() Source and output textures must be valid and of the same dimension"));
+        return -1;
+    }
+
+    if (Radius > MAX_RADIUS)
+    {
+        UE_LOG(LogRUL,Warning, TEXT("FRULTextureBlur::BoxBlur() Radius (%d) exceeds max radius, clamped to %d"), Radius, MAX_RADIUS);
+        Radius = MAX_RADIUS;
+    }
+
+    TArray<float> Weights;
+    Weights.Init(1.f / (2*Radius+1), Radius+1);
+
+    Blur(RHICmdList, SourceTexture, OutputTexture, Weights, EdgeMode, 1);
+
+    return 1;
+}
+
+void FRULTextureBlur::Blur(
+    FRHICommandListImmediate& RHICmdList,
+    FTextureRHIParamRef SourceTexture,
+    FTexture2DRHIParamRef OutputTexture,
+    const TArray<float>& Weights,
+    ERULShaderBlurEdgeMode EdgeMode,
+    int32 PassCount
+    )
+{
+    typedef FRULTextureBlurCS FBlurCS;
+
+    check(Weights.Num() > 0 && Weights.Num() <= (MAX_RADIUS+1));
+
+    const FIntPoint Dimension(OutputTexture->GetSizeX(), OutputTexture->GetSizeY());
+    const uint32 Radius = Weights.Num()-1;
+
+    FRULRHIRenderTargetPool& RenderTargetPool(FRULRHIRenderTargetPool::Get());
+
+    // Upload half kernel weights, packed four weights per element
+
+    TArray<FVector4> WeightData;
+    WeightData.SetNumZeroed(FMath::DivideAndRoundUp(Weights.Num(), 4));
+    FMemory::Memcpy(WeightData.GetData(), Weights.GetData(), Weights.Num() * sizeof(float));
+
+    FShaderResourceViewRHIRef WeightSRV;
+    uint32 WeightOffset;
+    FRULRHIUploadHeap::Get().UploadTypedData(RHICmdList, WeightData.GetData(), WeightData.Num(), WeightSRV, WeightOffset);
+
+    // Transposed intermediate texture of the horizontal pass, keeps 32-bit
+    // float outputs in their own format to avoid losing precision between passes
+
+    const EPixelFormat OutputFormat = OutputTexture->GetFormat();
+    const bool bFloat32Output = (
+        OutputFormat == PF_R32_FLOAT ||
+        OutputFormat == PF_G32R32F ||
+        OutputFormat == PF_A32B32G32R32F
+        );
+
+    FTexture2DRHIRef IntermediateTexture = RenderTargetPool.Acquire(
+        Dimension.Y,
+        Dimension.X,
+        bFloat32Output ? OutputFormat : PF_FloatRGBA,
+        0,
+        TexCreate_RenderTargetable | TexCreate_UAV,
+        1,
+        FClearValueBinding::None,
+        TEXT("RULTextureBlurIntermediate")
+        );
+
+    // Write to output texture directly if possible,
+    // otherwise write to a pooled texture and copy the result
+
+    FTexture2DRHIRef DstTexture = OutputTexture;
+
+    if ((OutputTexture->GetFlags() & TexCreate_UAV) == 0)
+    {
+        DstTexture = RenderTargetPool.Acquire(
+            Dimension.X,
+            Dimension.Y,
+            OutputTexture->GetFormat(),
+            0,
+            TexCreate_RenderTargetable | TexCreate_UAV,
+            1,
+            OutputTexture->GetClearBinding(),
+            TEXT("RULTextureBlurOutput")
+            );
+    }
+
+    FUnorderedAccessViewRHIRef IntermediateUAV = RHICreateUnorderedAccessView(IntermediateTexture, 0);
+    FUnorderedAccessViewRHIRef DstUAV = RHICreateUnorderedAccessView(DstTexture, 0);
+
+    TShaderMapRef<FBlurCS> BlurCS(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+    const FIntPoint TransposedDimension(Dimension.Y, Dimension.X);
+
+    FTextureRHIParamRef PassSourceTexture = SourceTexture;
+
+    for (int32 PassIndex=0; PassIndex<PassCount; ++PassIndex)
+    {
+        RHICmdList.BeginComputePass(TEXT("RULTextureBlur"));
+
+        // Horizontal pass, one group per row tile, writes the transposed result
+
+        BlurCS->SetShader(RHICmdList);
+        BlurCS->BindTexture(RHICmdList, FBlurCS::Slot_SourceTexture, PassSourceTexture);
+        BlurCS->BindSRV(RHICmdList, FBlurCS::Slot_WeightData, WeightSRV);
+        BlurCS->BindUAV(RHICmdList, FBlurCS::Slot_OutputTexture, IntermediateUAV);
+        BlurCS->SetParameter(RHICmdList, FBlurCS::Slot_Params_Dimension, Dimension);
+        BlurCS->SetParameter(RHICmdList, FBlurCS::Slot_Params_Radius, Radius);
+        BlurCS->SetParameter(RHICmdList, FBlurCS::Slot_Params_WeightOffset, WeightOffset);
+        BlurCS->SetParameter(RHICmdList, FBlurCS::Slot_Params_EdgeMode, static_cast<uint32>(EdgeMode));
+        DispatchComputeShader(RHICmdList, *BlurCS, FMath::DivideAndRoundUp(Dimension.X, TILE_SIZE), Dimension.Y, 1);
+        BlurCS->UnbindBuffers(RHICmdList);
+
+        // Vertical pass, blurs rows of the transposed intermediate
+        // and transposes the result back to the output orientation
+
+        BlurCS->SetShader(RHICmdList);
+        BlurCS->BindTexture(RHICmdList, FBlurCS::Slot_SourceTexture, IntermediateTexture);
+        BlurCS->BindSRV(RHICmdList, FBlurCS::Slot_WeightData, WeightSRV);
+        BlurCS->BindUAV(RHICmdList, FBlurCS::Slot_OutputTexture, DstUAV);
+        BlurCS->SetParameter(RHICmdList, FBlurCS::Slot_Params_Dimension, TransposedDimension);
+        BlurCS->SetParameter(RHICmdList, FBlurCS::Slot_Params_Radius, Radius);
+        BlurCS->SetParameter(RHICmdList, FBlurCS::Slot_Params_WeightOffset, WeightOffset);
+        BlurCS->SetParameter(RHICmdList, FBlurCS::Slot_Params_EdgeMode, static_cast<uint32>(EdgeMode));
+        DispatchComputeShader(RHICmdList, *BlurCS, FMath::DivideAndRoundUp(TransposedDimension.X, TILE_SIZE), TransposedDimension.Y, 1);
+        BlurCS->UnbindBuffers(RHICmdList);
+
+        RHICmdList.EndComputePass();
+
+        // Subsequent passes blur the previous pass result
+        PassSourceTexture = DstTexture;
+    }
+
+    IntermediateUAV.SafeRelease();
+    DstUAV.SafeRelease();
+
+    RenderTargetPool.Release(IntermediateTexture);
+
+    if (DstTexture != OutputTexture)
+    {
+        RHICmdList.CopyToResolveTarget(DstTexture, OutputTexture, FResolveParams());
+        RenderTargetPool.Release(DstTexture);
+    }
+}